@@ -0,0 +1,1146 @@
+﻿#include <Siv3D.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+#include "NocoUI.hpp"
+
+// ウィンドウ・GPUのない環境(LinuxのCIなど)でも実行できるようヘッドレスで起動する
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+// 計測区間内のヒープ確保の回数を数えるため、グローバルのoperator new・deleteを置き換える
+// (配列版・nothrow版は既定の実装がこれらを呼ぶため、置き換えなくても数えられる)
+// (エンジン内部のスレッドでのヒープ確保を含めないよう、スレッドごとに数える)
+namespace
+{
+	thread_local size_t t_heapAllocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	++t_heapAllocationCount;
+	if (void* p = std::malloc(size == 0 ? 1 : size))
+	{
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+using namespace noco;
+
+// 合成したCanvasに対してUI処理の各フェーズを個別に計測し、結果をJSONまたはCSVで出力する
+//
+// 使い方: NocoBench [--depth=N] [--fanout=N] [--layout=flow|horizontal|vertical|mixed] [--components=none|rect|label|mixed]
+//                   [--text-length=N] [--smoothing-count=N] [--hierarchy-nodes=N] [--iterations=N] [--warmup=N] [--seed=N] [--format=json|csv] [--output=path] [--scenario=name,...]
+//
+// 出力は1行につき1つの計測値(scenario, metric, value, unit)で、時間はすべてマイクロ秒
+namespace
+{
+	enum class LayoutMix : uint8
+	{
+		Flow,
+		Horizontal,
+		Vertical,
+		Mixed,
+	};
+
+	enum class ComponentMix : uint8
+	{
+		None,
+		Rect,
+		Label,
+		Mixed,
+	};
+
+	enum class OutputFormat : uint8
+	{
+		JSON,
+		CSV,
+	};
+
+	struct BenchConfig
+	{
+		int32 depth = 4;
+		int32 fanout = 6;
+		LayoutMix layoutMix = LayoutMix::Mixed;
+		ComponentMix componentMix = ComponentMix::Mixed;
+		int32 textLength = 16;
+		int32 smoothingCount = 100000;
+		int32 hierarchyNodeCount = 10000;
+		int32 iterations = 50;
+		int32 warmup = 5;
+		uint64 seed = 12345;
+		OutputFormat format = OutputFormat::JSON;
+		FilePath outputPath = U""; // 空の場合は標準出力
+		Array<String> scenarios; // 空の場合は全シナリオ
+	};
+
+	struct BenchResult
+	{
+		String scenario;
+		String metric;
+		double value = 0.0;
+		String unit;
+	};
+
+	class BenchReport
+	{
+	private:
+		Array<BenchResult> m_results;
+
+	public:
+		void add(StringView scenario, StringView metric, double value, StringView unit)
+		{
+			m_results.push_back(BenchResult{ String{ scenario }, String{ metric }, value, String{ unit } });
+		}
+
+		// 1回あたりの所要時間(マイクロ秒)の統計を追加する
+		void addTimings(StringView scenario, Array<double> timesUs)
+		{
+			if (timesUs.empty())
+			{
+				return;
+			}
+			timesUs.sort();
+			const double total = timesUs.sum();
+			add(scenario, U"mean", total / timesUs.size(), U"us");
+			add(scenario, U"median", timesUs[timesUs.size() / 2], U"us");
+			add(scenario, U"min", timesUs.front(), U"us");
+			add(scenario, U"max", timesUs.back(), U"us");
+		}
+
+		[[nodiscard]]
+		const Array<BenchResult>& results() const
+		{
+			return m_results;
+		}
+	};
+
+	// 合成したCanvasと、計測中に操作する対象
+	struct BenchTree
+	{
+		std::shared_ptr<Canvas> canvas;
+		Array<std::shared_ptr<Node>> nodes; // ルートを除く全ノード
+		Array<std::shared_ptr<RectRenderer>> rectRenderers;
+	};
+
+	constexpr RectF LayoutAreaA{ 0, 0, 1280, 720 };
+	constexpr RectF LayoutAreaB{ 0, 0, 1281, 721 };
+
+	[[nodiscard]]
+	StringView LayoutMixToString(LayoutMix layoutMix)
+	{
+		switch (layoutMix)
+		{
+		case LayoutMix::Flow:
+			return U"flow";
+		case LayoutMix::Horizontal:
+			return U"horizontal";
+		case LayoutMix::Vertical:
+			return U"vertical";
+		case LayoutMix::Mixed:
+			return U"mixed";
+		}
+		throw Error{ U"LayoutMixToString: Invalid layoutMix" };
+	}
+
+	[[nodiscard]]
+	StringView ComponentMixToString(ComponentMix componentMix)
+	{
+		switch (componentMix)
+		{
+		case ComponentMix::None:
+			return U"none";
+		case ComponentMix::Rect:
+			return U"rect";
+		case ComponentMix::Label:
+			return U"label";
+		case ComponentMix::Mixed:
+			return U"mixed";
+		}
+		throw Error{ U"ComponentMixToString: Invalid componentMix" };
+	}
+
+	[[nodiscard]]
+	int32 ParseCount(StringView key, StringView value, int32 minValue)
+	{
+		const auto parsed = ParseOpt<int32>(value);
+		if (!parsed || *parsed < minValue)
+		{
+			throw Error{ U"ParseCount: --{} must be an integer >= {} (got '{}')"_fmt(key, minValue, value) };
+		}
+		return *parsed;
+	}
+
+	[[nodiscard]]
+	BenchConfig ParseCommandLine(const Array<String>& args)
+	{
+		BenchConfig config;
+
+		// 先頭は実行ファイルのパス
+		for (size_t i = 1; i < args.size(); ++i)
+		{
+			const String& arg = args[i];
+			if (!arg.starts_with(U"--"))
+			{
+				throw Error{ U"ParseCommandLine: Unknown argument '{}'"_fmt(arg) };
+			}
+			const size_t separatorPos = arg.indexOf(U'=');
+			if (separatorPos == String::npos)
+			{
+				throw Error{ U"ParseCommandLine: Argument '{}' must be in the form --key=value"_fmt(arg) };
+			}
+			const String key = arg.substr(2, separatorPos - 2);
+			const String value = arg.substr(separatorPos + 1);
+
+			if (key == U"depth")
+			{
+				config.depth = ParseCount(key, value, 1);
+			}
+			else if (key == U"fanout")
+			{
+				config.fanout = ParseCount(key, value, 1);
+			}
+			else if (key == U"layout")
+			{
+				if (value == U"flow")
+				{
+					config.layoutMix = LayoutMix::Flow;
+				}
+				else if (value == U"horizontal")
+				{
+					config.layoutMix = LayoutMix::Horizontal;
+				}
+				else if (value == U"vertical")
+				{
+					config.layoutMix = LayoutMix::Vertical;
+				}
+				else if (value == U"mixed")
+				{
+					config.layoutMix = LayoutMix::Mixed;
+				}
+				else
+				{
+					throw Error{ U"ParseCommandLine: Unknown layout '{}'"_fmt(value) };
+				}
+			}
+			else if (key == U"components")
+			{
+				if (value == U"none")
+				{
+					config.componentMix = ComponentMix::None;
+				}
+				else if (value == U"rect")
+				{
+					config.componentMix = ComponentMix::Rect;
+				}
+				else if (value == U"label")
+				{
+					config.componentMix = ComponentMix::Label;
+				}
+				else if (value == U"mixed")
+				{
+					config.componentMix = ComponentMix::Mixed;
+				}
+				else
+				{
+					throw Error{ U"ParseCommandLine: Unknown components '{}'"_fmt(value) };
+				}
+			}
+			else if (key == U"text-length")
+			{
+				config.textLength = ParseCount(key, value, 0);
+			}
+			else if (key == U"smoothing-count")
+			{
+				config.smoothingCount = ParseCount(key, value, 1);
+			}
+			else if (key == U"hierarchy-nodes")
+			{
+				config.hierarchyNodeCount = ParseCount(key, value, 1);
+			}
+			else if (key == U"iterations")
+			{
+				config.iterations = ParseCount(key, value, 1);
+			}
+			else if (key == U"warmup")
+			{
+				config.warmup = ParseCount(key, value, 0);
+			}
+			else if (key == U"seed")
+			{
+				config.seed = static_cast<uint64>(ParseCount(key, value, 0));
+			}
+			else if (key == U"format")
+			{
+				if (value == U"json")
+				{
+					config.format = OutputFormat::JSON;
+				}
+				else if (value == U"csv")
+				{
+					config.format = OutputFormat::CSV;
+				}
+				else
+				{
+					throw Error{ U"ParseCommandLine: Unknown format '{}'"_fmt(value) };
+				}
+			}
+			else if (key == U"output")
+			{
+				config.outputPath = value;
+			}
+			else if (key == U"scenario")
+			{
+				config.scenarios = value.split(U',').removed_if([](const String& name) { return name.isEmpty(); });
+			}
+			else
+			{
+				throw Error{ U"ParseCommandLine: Unknown option '--{}'"_fmt(key) };
+			}
+		}
+		return config;
+	}
+
+	// fnPrepareは計測に含めない
+	template <class FtyPrepare, class Fty>
+	[[nodiscard]]
+	Array<double> MeasureUs(const BenchConfig& config, FtyPrepare fnPrepare, Fty fn)
+	{
+		for (int32 i = 0; i < config.warmup; ++i)
+		{
+			fnPrepare();
+			fn();
+		}
+
+		Array<double> timesUs;
+		timesUs.reserve(config.iterations);
+		for (int32 i = 0; i < config.iterations; ++i)
+		{
+			fnPrepare();
+			const Stopwatch stopwatch{ StartImmediately::Yes };
+			fn();
+			timesUs.push_back(stopwatch.usF());
+		}
+		return timesUs;
+	}
+
+	template <class Fty>
+	[[nodiscard]]
+	Array<double> MeasureUs(const BenchConfig& config, Fty fn)
+	{
+		return MeasureUs(config, [] {}, fn);
+	}
+
+	[[nodiscard]]
+	LayoutVariant CreateLayout(LayoutMix layoutMix, int32 level)
+	{
+		switch (layoutMix)
+		{
+		case LayoutMix::Flow:
+			return FlowLayout{};
+		case LayoutMix::Horizontal:
+			return HorizontalLayout{};
+		case LayoutMix::Vertical:
+			return VerticalLayout{};
+		case LayoutMix::Mixed:
+			// 階層ごとに横・縦・折り返しを入れ替える(ダッシュボード状のパネルの入れ子を想定)
+			switch (level % 3)
+			{
+			case 0:
+				return HorizontalLayout{};
+			case 1:
+				return VerticalLayout{};
+			default:
+				return FlowLayout{};
+			}
+		}
+		throw Error{ U"CreateLayout: Invalid layoutMix" };
+	}
+
+	[[nodiscard]]
+	String CreateText(int32 length)
+	{
+		String text;
+		text.reserve(length);
+		for (int32 i = 0; i < length; ++i)
+		{
+			text.push_back((i % 8 == 7) ? U' ' : static_cast<char32>(U'a' + Random(25)));
+		}
+		return text;
+	}
+
+	void AddComponents(const std::shared_ptr<Node>& node, const BenchConfig& config, size_t index, BenchTree& tree)
+	{
+		const bool addsRect = config.componentMix == ComponentMix::Rect || config.componentMix == ComponentMix::Mixed;
+		const bool addsLabel = config.componentMix == ComponentMix::Label || (config.componentMix == ComponentMix::Mixed && index % 2 == 0);
+		if (addsRect)
+		{
+			tree.rectRenderers.push_back(node->emplaceComponent<RectRenderer>(
+				PropertyValue<ColorF>{ ColorF{ 0.2 }, ColorF{ 0.3 }, ColorF{ 0.4 }, none, 0.1 },
+				ColorF{ 0.8 },
+				1.0,
+				4.0));
+		}
+		if (addsLabel)
+		{
+			node->emplaceComponent<Label>(CreateText(config.textLength), U"", 14.0, ColorF{ 1.0 }, HorizontalAlign::Center, VerticalAlign::Middle);
+		}
+	}
+
+	void BuildChildren(const std::shared_ptr<Node>& parent, const BenchConfig& config, int32 level, BenchTree& tree)
+	{
+		if (level >= config.depth)
+		{
+			return;
+		}
+		parent->setLayout(CreateLayout(config.layoutMix, level), RefreshesLayoutYN::No);
+
+		const bool isLeaf = level + 1 >= config.depth;
+		for (int32 i = 0; i < config.fanout; ++i)
+		{
+			const size_t index = tree.nodes.size();
+
+			// 親のサイズに追従するコンテナと固定サイズの葉で、親の矩形が変わると子孫全体が再計算されるようにする
+			const BoxConstraint constraint = isLeaf
+				? BoxConstraint{ .sizeDelta = Vec2{ 48, 20 } }
+				: BoxConstraint{ .sizeRatio = Vec2{ 1.0, 1.0 } / config.fanout, .flexibleWeight = 1.0 };
+			const auto& child = parent->emplaceChild(U"Node{}"_fmt(index), constraint, IsHitTargetYN::Yes, InheritChildrenStateFlags::None, RefreshesLayoutYN::No);
+			tree.nodes.push_back(child);
+			AddComponents(child, config, index, tree);
+			BuildChildren(child, config, level + 1, tree);
+		}
+	}
+
+	[[nodiscard]]
+	BenchTree CreateTree(const BenchConfig& config)
+	{
+		Reseed(config.seed);
+
+		BenchTree tree;
+		tree.canvas = Canvas::Create();
+		BuildChildren(tree.canvas->rootNode(), config, 0, tree);
+
+		// ウィンドウサイズに依存しないよう固定の領域でレイアウトする
+		tree.canvas->setLayoutArea(LayoutAreaA);
+		return tree;
+	}
+
+	// ルートを除くノード数
+	[[nodiscard]]
+	size_t NodeCount(const BenchConfig& config)
+	{
+		size_t count = 0;
+		size_t levelCount = 1;
+		for (int32 level = 0; level < config.depth; ++level)
+		{
+			levelCount *= config.fanout;
+			count += levelCount;
+		}
+		return count;
+	}
+
+	// ノードの生成と初回のレイアウト
+	void RunBuild(const BenchConfig& config, BenchReport& report)
+	{
+		report.addTimings(U"build", MeasureUs(config, [&] { (void)CreateTree(config); }));
+	}
+
+	void RunLayout(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+
+		// レイアウト領域のサイズを毎回変えることで、全ノードのレイアウトを計算し直させる
+		bool usesAreaB = false;
+		report.addTimings(U"layout", MeasureUs(config,
+			[&]
+			{
+				usesAreaB = !usesAreaB;
+				tree.canvas->setLayoutArea(usesAreaB ? LayoutAreaB : LayoutAreaA, RefreshesLayoutYN::No);
+			},
+			[&] { tree.canvas->refreshLayout(); }));
+
+		// 定常状態のレイアウト更新でのヒープ確保の回数(0でなければ失敗とする)
+		// (両方の領域で1回ずつレイアウトして作業領域の容量を確保させてから数える)
+		for (int32 i = 0; i < 2; ++i)
+		{
+			usesAreaB = !usesAreaB;
+			tree.canvas->setLayoutArea(usesAreaB ? LayoutAreaB : LayoutAreaA);
+		}
+		const size_t scratchGrowthCountBefore = tree.canvas->layoutAllocationCount();
+		const size_t heapAllocationCountBefore = t_heapAllocationCount;
+		for (int32 i = 0; i < config.iterations; ++i)
+		{
+			usesAreaB = !usesAreaB;
+			tree.canvas->setLayoutArea(usesAreaB ? LayoutAreaB : LayoutAreaA);
+		}
+		const size_t heapAllocationCount = t_heapAllocationCount - heapAllocationCountBefore;
+		report.add(U"layout", U"steady_state_allocations", static_cast<double>(heapAllocationCount), U"count");
+		report.add(U"layout", U"steady_state_scratch_growths", static_cast<double>(tree.canvas->layoutAllocationCount() - scratchGrowthCountBefore), U"count");
+		if (heapAllocationCount != 0)
+		{
+			throw Error{ U"RunLayout: {} heap allocations in steady-state layout"_fmt(heapAllocationCount) };
+		}
+
+		// 変更がない場合のレイアウト更新(変更のないサブツリーの省略にかかる時間)
+		report.addTimings(U"layout_unchanged", MeasureUs(config, [&] { tree.canvas->refreshLayout(); }));
+	}
+
+	[[nodiscard]]
+	double Median(Array<double> values)
+	{
+		values.sort();
+		return values[values.size() / 2];
+	}
+
+	// 逐次と並列(ルート直下の子のサブツリーを並列に計算)での全ノードのレイアウトの比較
+	void RunLayoutParallel(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+		bool usesAreaB = false;
+		const auto fnPrepare = [&]
+			{
+				usesAreaB = !usesAreaB;
+				tree.canvas->setLayoutArea(usesAreaB ? LayoutAreaB : LayoutAreaA, RefreshesLayoutYN::No);
+			};
+		const auto fnLayout = [&] { tree.canvas->refreshLayout(); };
+
+		tree.canvas->setParallelLayoutThreshold(0);
+		const Array<double> sequentialTimesUs = MeasureUs(config, fnPrepare, fnLayout);
+		tree.canvas->setLayoutArea(LayoutAreaA);
+		const Array<RectF> sequentialRects = tree.nodes.map([](const std::shared_ptr<Node>& node) { return node->layoutAppliedRect(); });
+
+		tree.canvas->setParallelLayoutThreshold(static_cast<size_t>(config.fanout));
+		const Array<double> parallelTimesUs = MeasureUs(config, fnPrepare, fnLayout);
+		tree.canvas->setLayoutArea(LayoutAreaB);
+		tree.canvas->setLayoutArea(LayoutAreaA);
+
+		// 並列の場合も逐次の場合と完全に同じ矩形になっていること
+		size_t mismatchCount = 0;
+		for (size_t i = 0; i < tree.nodes.size(); ++i)
+		{
+			if (tree.nodes[i]->layoutAppliedRect() != sequentialRects[i])
+			{
+				++mismatchCount;
+			}
+		}
+		tree.canvas->setParallelLayoutThreshold(0);
+
+		report.add(U"layout_parallel", U"hardware_threads", static_cast<double>(std::thread::hardware_concurrency()), U"count");
+		report.add(U"layout_parallel", U"sequential_median", Median(sequentialTimesUs), U"us");
+		report.add(U"layout_parallel", U"parallel_median", Median(parallelTimesUs), U"us");
+		report.add(U"layout_parallel", U"speedup", Median(sequentialTimesUs) / Median(parallelTimesUs), U"ratio");
+		report.add(U"layout_parallel", U"rect_mismatches", static_cast<double>(mismatchCount), U"count");
+	}
+
+	void RunUpdate(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+
+		// 入力・変更のない状態での更新
+		report.addTimings(U"update_idle", MeasureUs(config, [&] { tree.canvas->update(); }));
+
+		// 一部のノードの選択状態を切り替えてからの更新(操作による状態変化。ヘッドレスではカーソルを動かせないため選択状態で代用する)
+		bool selected = false;
+		report.addTimings(U"update_interaction", MeasureUs(config,
+			[&] { selected = !selected; },
+			[&]
+			{
+				for (size_t i = 0; i < tree.nodes.size(); i += 10)
+				{
+					tree.nodes[i]->setSelected(selected);
+				}
+				tree.canvas->update();
+			}));
+
+		// 全RectRendererのプロパティを変更してからの更新(プロパティの変更とスムージング)
+		bool toggled = false;
+		report.addTimings(U"update_properties", MeasureUs(config,
+			[&] { toggled = !toggled; },
+			[&]
+			{
+				const ColorF color = toggled ? ColorF{ 0.6 } : ColorF{ 0.2 };
+				for (const auto& rectRenderer : tree.rectRenderers)
+				{
+					rectRenderer->setFillColor(PropertyValue<ColorF>{ color, ColorF{ 0.3 }, ColorF{ 0.4 }, none, 0.1 });
+				}
+				tree.canvas->update();
+			}));
+
+		// 同じ変更をプロパティのSmoothDampをまとめて計算する設定で更新
+		tree.canvas->setBatchedSmoothingEnabled(true);
+		report.addTimings(U"update_properties_batched", MeasureUs(config,
+			[&] { toggled = !toggled; },
+			[&]
+			{
+				const ColorF color = toggled ? ColorF{ 0.6 } : ColorF{ 0.2 };
+				for (const auto& rectRenderer : tree.rectRenderers)
+				{
+					rectRenderer->setFillColor(PropertyValue<ColorF>{ color, ColorF{ 0.3 }, ColorF{ 0.4 }, none, 0.1 });
+				}
+				tree.canvas->update();
+			}));
+	}
+
+	// リテインドモード・部分再描画で、更新の省略・描画結果の再利用・部分再描画が期待通りに行われること
+	// (計測値ではなく統計情報の回数を確認し、期待と異なる場合は失敗とする。ヘッドレスではカーソルを動かせないため、ホバーは確認できない)
+	void RunRetained(const BenchConfig& config, BenchReport& report)
+	{
+		constexpr int32 IdleFrameCount = 5;
+
+		const BenchTree tree = CreateTree(config);
+		tree.canvas->setRetainedModeEnabled(true);
+		tree.canvas->setPartialRedrawEnabled(true);
+		tree.canvas->setStatsEnabled(true);
+
+		// ヘッドレスのレンダラーでRenderTextureを作成できない場合は、描画に関する回数は確認しない
+		const bool checksDraw = !RenderTexture{ Size{ 1, 1 } }.isEmpty();
+
+		const auto fnFrame = [&]
+			{
+				tree.canvas->update();
+				tree.canvas->draw();
+			};
+
+		// Scene::FrameCount()が進まないため、フェーズごとにリセットして累計の回数を確認する
+		const auto fnMeasure = [&](StringView phase, int32 frameCount)
+			{
+				fnFrame(); // 初回の描画・直前の変更の反映を済ませておく
+				tree.canvas->resetStats();
+				for (int32 i = 0; i < frameCount; ++i)
+				{
+					fnFrame();
+				}
+				const CanvasStats stats = tree.canvas->stats();
+				report.add(U"retained", U"{}_skipped_updates"_fmt(phase), static_cast<double>(stats.skippedUpdateCount), U"count");
+				report.add(U"retained", U"{}_cached_draws"_fmt(phase), static_cast<double>(stats.cachedDrawCount), U"count");
+				report.add(U"retained", U"{}_partial_redraw_rects"_fmt(phase), static_cast<double>(stats.partialRedrawRectCount), U"count");
+				return stats;
+			};
+
+		const auto fnExpect = [](bool condition, StringView description)
+			{
+				if (!condition)
+				{
+					throw Error{ U"RunRetained: {}"_fmt(description) };
+				}
+			};
+
+		// 入力・変更のないフレームは更新を省略し、前回の描画結果をそのまま使用する
+		fnFrame();
+		{
+			const CanvasStats stats = fnMeasure(U"idle", IdleFrameCount);
+			fnExpect(stats.skippedUpdateCount == IdleFrameCount, U"Idle frames were not skipped");
+			fnExpect(!checksDraw || stats.cachedDrawCount == IdleFrameCount, U"Idle frames were redrawn");
+			fnExpect(stats.partialRedrawRectCount == 0, U"Idle frames were partially redrawn");
+		}
+
+		// 選択状態の変更は更新され、変化したノードの範囲のみ描画し直す
+		if (!tree.nodes.empty())
+		{
+			const auto& node = tree.nodes.front();
+			const bool hasDrawBounds = node->drawBounds().has_value();
+			tree.canvas->resetStats();
+			node->setSelected(true);
+			fnFrame();
+			const CanvasStats stats = tree.canvas->stats();
+			report.add(U"retained", U"selected_partial_redraw_rects", static_cast<double>(stats.partialRedrawRectCount), U"count");
+			fnExpect(stats.skippedUpdateCount == 0, U"Update was skipped after setSelected");
+			fnExpect(!checksDraw || stats.cachedDrawCount == 0, U"Cached result was drawn after setSelected");
+			fnExpect(!checksDraw || !hasDrawBounds || stats.partialRedrawRectCount > 0, U"Selected node was not partially redrawn");
+		}
+
+		// プロパティの変更(スムージングなし)も同様に、変化したコンポーネントの範囲のみ描画し直す
+		if (!tree.rectRenderers.empty())
+		{
+			tree.canvas->resetStats();
+			tree.rectRenderers.front()->setFillColor(ColorF{ 0.6 });
+			fnFrame();
+			const CanvasStats stats = tree.canvas->stats();
+			report.add(U"retained", U"property_partial_redraw_rects", static_cast<double>(stats.partialRedrawRectCount), U"count");
+			fnExpect(stats.skippedUpdateCount == 0, U"Update was skipped after a property change");
+			fnExpect(!checksDraw || stats.cachedDrawCount == 0, U"Cached result was drawn after a property change");
+			fnExpect(!checksDraw || stats.partialRedrawRectCount > 0, U"Changed component was not partially redrawn");
+		}
+
+		// 変更の反映後は再び省略される
+		{
+			const CanvasStats stats = fnMeasure(U"idle_after_change", IdleFrameCount);
+			fnExpect(stats.skippedUpdateCount == IdleFrameCount, U"Idle frames after a change were not skipped");
+			fnExpect(!checksDraw || stats.cachedDrawCount == IdleFrameCount, U"Idle frames after a change were redrawn");
+		}
+
+		// Canvasに属していないノードの変更は、Canvasの更新の省略を妨げない
+		{
+			const auto detachedNode = Node::Create(U"Detached");
+			const auto rectRenderer = detachedNode->emplaceComponent<RectRenderer>(ColorF{ 0.2 });
+			fnFrame();
+			tree.canvas->resetStats();
+			for (int32 i = 0; i < IdleFrameCount; ++i)
+			{
+				rectRenderer->setFillColor(ColorF{ (i % 2) ? 0.2 : 0.6 });
+				detachedNode->setSelected(i % 2 == 0);
+				fnFrame();
+			}
+			const CanvasStats stats = tree.canvas->stats();
+			report.add(U"retained", U"detached_change_skipped_updates", static_cast<double>(stats.skippedUpdateCount), U"count");
+			fnExpect(stats.skippedUpdateCount == IdleFrameCount, U"Changes to a detached node prevented skipping");
+		}
+
+		report.add(U"retained", U"draw_checked", checksDraw ? 1.0 : 0.0, U"bool");
+	}
+
+	void RunSerialization(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+
+		report.addTimings(U"to_json", MeasureUs(config, [&] { (void)tree.canvas->toJSON(); }));
+
+		const JSON json = tree.canvas->toJSON();
+		report.addTimings(U"json_format", MeasureUs(config, [&] { (void)json.formatMinimum(); }));
+		report.add(U"json_format", U"bytes", static_cast<double>(json.formatMinimum().toUTF8().size()), U"bytes");
+
+		report.addTimings(U"from_json", MeasureUs(config, [&] { (void)Canvas::CreateFromJSON(json, RefreshesLayoutYN::No); }));
+	}
+
+	void RunClone(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+		report.addTimings(U"clone", MeasureUs(config, [&] { (void)tree.canvas->rootNode()->clone(); }));
+	}
+
+	// 型IDの索引を使わない従来の検索(比較用)
+	template <class TComponent>
+	[[nodiscard]]
+	std::shared_ptr<TComponent> FindComponentByScan(const Node& node)
+	{
+		for (const auto& component : node.components())
+		{
+			if (auto concreteComponent = std::dynamic_pointer_cast<TComponent>(component))
+			{
+				return concreteComponent;
+			}
+		}
+		return nullptr;
+	}
+
+	// 全ノードに対するgetComponentOrNullの検索(索引あり)と、dynamic_pointer_castによる線形探索の比較
+	void RunComponentLookup(const BenchConfig& config, BenchReport& report)
+	{
+		const BenchTree tree = CreateTree(config);
+
+		// 追加時の型での検索(索引から取得される)
+		report.addTimings(U"component_lookup_indexed", MeasureUs(config,
+			[&]
+			{
+				for (const auto& node : tree.nodes)
+				{
+					(void)node->getComponentOrNull<Label>();
+				}
+			}));
+		report.addTimings(U"component_lookup_scan", MeasureUs(config,
+			[&]
+			{
+				for (const auto& node : tree.nodes)
+				{
+					(void)FindComponentByScan<Label>(*node);
+				}
+			}));
+
+		// 持っていないコンポーネントの検索(再帰的な検索ではほとんどのノードで見つからない)
+		// (一度見つからなかった型は索引に記録されるため、2回目以降は探索しない)
+		report.addTimings(U"component_lookup_indexed_miss", MeasureUs(config,
+			[&]
+			{
+				for (const auto& node : tree.nodes)
+				{
+					(void)node->getComponentOrNull<Sprite>();
+				}
+			}));
+		report.addTimings(U"component_lookup_scan_miss", MeasureUs(config,
+			[&]
+			{
+				for (const auto& node : tree.nodes)
+				{
+					(void)FindComponentByScan<Sprite>(*node);
+				}
+			}));
+
+		// 基底クラスでの検索(初回のみ線形探索し、結果は索引に記録される)
+		report.addTimings(U"component_lookup_base", MeasureUs(config,
+			[&]
+			{
+				for (const auto& node : tree.nodes)
+				{
+					(void)node->getComponentOrNull<ComponentBase>();
+				}
+			}));
+		report.add(U"component_lookup", U"lookups_per_iteration", static_cast<double>(tree.nodes.size()), U"count");
+	}
+
+	// アニメーション中のプロパティ(double・Vec2・ColorFを順に混ぜたもの)
+	// (コンポーネントに含まれる場合と同様に、個別にヒープに確保する)
+	class SmoothingSet
+	{
+	private:
+		Array<std::unique_ptr<IProperty>> m_properties;
+		size_t m_toggleCount = 0;
+
+	public:
+		explicit SmoothingSet(size_t count)
+		{
+			m_properties.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				switch (i % 3)
+				{
+				case 0:
+					m_properties.push_back(std::make_unique<SmoothProperty<double>>(U"value", PropertyValue<double>{ 0.0 }));
+					break;
+				case 1:
+					m_properties.push_back(std::make_unique<SmoothProperty<Vec2>>(U"value", PropertyValue<Vec2>{ Vec2::Zero() }));
+					break;
+				default:
+					m_properties.push_back(std::make_unique<SmoothProperty<ColorF>>(U"value", PropertyValue<ColorF>{ ColorF{ 0.0 } }));
+					break;
+				}
+			}
+		}
+
+		// 目標値を切り替えて全プロパティをアニメーション中にする
+		// (成分ごとに異なる方向・距離へ向かわせ、速度が残った状態で目標値を越える場合も含まれるようにする)
+		void toggleTargets()
+		{
+			++m_toggleCount;
+			const auto fnTarget = [this](size_t index, size_t lane) { return Math::Fraction(m_toggleCount * 0.618 + (index * 4 + lane) * 0.37); };
+			for (size_t i = 0; i < m_properties.size(); ++i)
+			{
+				IProperty* property = m_properties[i].get();
+				switch (i % 3)
+				{
+				case 0:
+					static_cast<SmoothProperty<double>*>(property)->setPropertyValue(PropertyValue<double>{ fnTarget(i, 0), none, none, none, 0.5 });
+					break;
+				case 1:
+					static_cast<SmoothProperty<Vec2>*>(property)->setPropertyValue(PropertyValue<Vec2>{ Vec2{ fnTarget(i, 0), fnTarget(i, 1) }, none, none, none, 0.5 });
+					break;
+				default:
+					static_cast<SmoothProperty<ColorF>*>(property)->setPropertyValue(PropertyValue<ColorF>{ ColorF{ fnTarget(i, 0), fnTarget(i, 1), fnTarget(i, 2), fnTarget(i, 3) }, none, none, none, 0.5 });
+					break;
+				}
+			}
+		}
+
+		[[nodiscard]]
+		const Array<std::unique_ptr<IProperty>>& properties() const
+		{
+			return m_properties;
+		}
+
+		// 成分ごとの値の差の最大値
+		[[nodiscard]]
+		double maxDifference(const SmoothingSet& other) const
+		{
+			double maxDifference = 0.0;
+			for (size_t i = 0; i < m_properties.size(); ++i)
+			{
+				const IProperty* property = m_properties[i].get();
+				const IProperty* otherProperty = other.m_properties[i].get();
+				switch (i % 3)
+				{
+				case 0:
+					maxDifference = Max(maxDifference, Abs(static_cast<const SmoothProperty<double>*>(property)->value() - static_cast<const SmoothProperty<double>*>(otherProperty)->value()));
+					break;
+				case 1:
+				{
+					const Vec2 diff = static_cast<const SmoothProperty<Vec2>*>(property)->value() - static_cast<const SmoothProperty<Vec2>*>(otherProperty)->value();
+					maxDifference = std::max({ maxDifference, Abs(diff.x), Abs(diff.y) });
+					break;
+				}
+				default:
+				{
+					const ColorF& color = static_cast<const SmoothProperty<ColorF>*>(property)->value();
+					const ColorF& otherColor = static_cast<const SmoothProperty<ColorF>*>(otherProperty)->value();
+					maxDifference = std::max({ maxDifference, Abs(color.r - otherColor.r), Abs(color.g - otherColor.g), Abs(color.b - otherColor.b), Abs(color.a - otherColor.a) });
+					break;
+				}
+				}
+			}
+			return maxDifference;
+		}
+	};
+
+	// プロパティごとの仮想関数呼び出しによるSmoothDampと、連続した配列に集約してまとめて計算する場合の比較
+	void RunSmoothing(const BenchConfig& config, BenchReport& report)
+	{
+		constexpr double DeltaTime = 1.0 / 60.0;
+		const size_t count = static_cast<size_t>(config.smoothingCount);
+
+		SmoothingSet scalarSet{ count };
+		report.addTimings(U"smoothing_scalar", MeasureUs(config,
+			[&] { scalarSet.toggleTargets(); },
+			[&]
+			{
+				for (const auto& property : scalarSet.properties())
+				{
+					property->update(InteractState::Default, SelectedYN::No, DeltaTime);
+				}
+			}));
+
+		SmoothingSet batchedSet{ count };
+		detail::SmoothingBatch batch;
+		size_t laneCount = 0;
+		report.addTimings(U"smoothing_batched", MeasureUs(config,
+			[&] { batchedSet.toggleTargets(); },
+			[&]
+			{
+				for (const auto& property : batchedSet.properties())
+				{
+					property->updateBatched(InteractState::Default, SelectedYN::No, DeltaTime, batch);
+				}
+				laneCount = batch.laneCount();
+				batch.execute(DeltaTime);
+			}));
+
+		report.add(U"smoothing", U"properties", static_cast<double>(count), U"count");
+		report.add(U"smoothing", U"lanes", static_cast<double>(laneCount), U"count");
+
+		// 同じ手順で更新した結果が完全に一致すること(一致しなければ失敗とする)
+		// (計測とは別に、数フレームごとに目標値を切り替えながら毎フレーム比較する)
+		double maxDifference = scalarSet.maxDifference(batchedSet);
+		{
+			constexpr int32 FrameCount = 120;
+			constexpr int32 ToggleInterval = 7;
+			const size_t checkCount = Min<size_t>(count, 3000);
+			SmoothingSet scalarCheckSet{ checkCount };
+			SmoothingSet batchedCheckSet{ checkCount };
+			detail::SmoothingBatch checkBatch;
+			for (int32 frame = 0; frame < FrameCount; ++frame)
+			{
+				if (frame % ToggleInterval == 0)
+				{
+					scalarCheckSet.toggleTargets();
+					batchedCheckSet.toggleTargets();
+				}
+				for (const auto& property : scalarCheckSet.properties())
+				{
+					property->update(InteractState::Default, SelectedYN::No, DeltaTime);
+				}
+				for (const auto& property : batchedCheckSet.properties())
+				{
+					property->updateBatched(InteractState::Default, SelectedYN::No, DeltaTime, checkBatch);
+				}
+				checkBatch.execute(DeltaTime);
+				maxDifference = Max(maxDifference, scalarCheckSet.maxDifference(batchedCheckSet));
+			}
+		}
+		report.add(U"smoothing", U"max_abs_difference", maxDifference, U"value");
+		if (maxDifference != 0.0)
+		{
+			throw Error{ U"RunSmoothing: Batched results differ from scalar results (max difference: {})"_fmt(maxDifference) };
+		}
+	}
+
+	// エディタのHierarchyの行に相当する要素
+	struct HierarchyElement
+	{
+		std::shared_ptr<Node> node;
+		size_t nestLevel = 0;
+	};
+
+	void AddHierarchyElements(Array<HierarchyElement>& elements, const std::shared_ptr<Node>& node, size_t nestLevel)
+	{
+		elements.push_back(HierarchyElement{ node, nestLevel });
+		for (const auto& child : node->children())
+		{
+			AddHierarchyElements(elements, child, nestLevel + 1);
+		}
+	}
+
+	// エディタのHierarchyと同様に、ノードを深さ優先順に並べた要素の配列からノードに対応する要素を探す場合の比較
+	// (エディタはWindows専用のため、要素の配列と索引の持ち方のみを再現して計測する)
+	void RunHierarchyLookup(const BenchConfig& config, BenchReport& report)
+	{
+		// 1ノードあたり子10個のツリーを指定のノード数に達するまで幅優先で作る
+		const size_t hierarchyNodeCount = static_cast<size_t>(config.hierarchyNodeCount);
+		const auto rootNode = Node::Create(U"Root");
+		{
+			Array<std::shared_ptr<Node>> queue{ rootNode };
+			for (size_t queueIndex = 0; queue.size() < hierarchyNodeCount; ++queueIndex)
+			{
+				for (int32 i = 0; i < 10 && queue.size() < hierarchyNodeCount; ++i)
+				{
+					queue.push_back(queue[queueIndex]->emplaceChild(U"Node{}"_fmt(queue.size()), BoxConstraint{}, IsHitTargetYN::Yes, InheritChildrenStateFlags::None, RefreshesLayoutYN::No));
+				}
+			}
+		}
+		Array<HierarchyElement> elements;
+		AddHierarchyElements(elements, rootNode, 0);
+
+		HashTable<std::shared_ptr<Node>, size_t> elementIndexByNode;
+		report.addTimings(U"hierarchy_index_refresh", MeasureUs(config,
+			[&]
+			{
+				elementIndexByNode.clear();
+				elementIndexByNode.reserve(elements.size());
+				for (size_t i = 0; i < elements.size(); ++i)
+				{
+					elementIndexByNode.emplace(elements[i].node, i);
+				}
+			}));
+
+		// 折りたたみの適用などと同様に、全ノードについて対応する要素を探す
+		size_t foundCount = 0;
+		report.addTimings(U"hierarchy_lookup_find_if", MeasureUs(config,
+			[&]
+			{
+				for (const auto& element : elements)
+				{
+					const auto it = std::find_if(elements.begin(), elements.end(), [&](const HierarchyElement& e) { return e.node == element.node; });
+					foundCount += (it != elements.end());
+				}
+			}));
+		report.addTimings(U"hierarchy_lookup_map", MeasureUs(config,
+			[&]
+			{
+				for (const auto& element : elements)
+				{
+					foundCount += elementIndexByNode.contains(element.node);
+				}
+			}));
+		if (foundCount != elements.size() * (config.warmup + config.iterations) * 2)
+		{
+			throw Error{ U"RunHierarchyLookup: Some elements were not found" };
+		}
+		report.add(U"hierarchy_lookup", U"lookups_per_iteration", static_cast<double>(elements.size()), U"count");
+	}
+
+	struct BenchScenario
+	{
+		StringView name;
+		void (*fnRun)(const BenchConfig&, BenchReport&);
+	};
+
+	[[nodiscard]]
+	const Array<BenchScenario>& Scenarios()
+	{
+		static const Array<BenchScenario> scenarios
+		{
+			{ U"build", RunBuild },
+			{ U"layout", RunLayout },
+			{ U"layout_parallel", RunLayoutParallel },
+			{ U"update", RunUpdate },
+			{ U"retained", RunRetained },
+			{ U"serialization", RunSerialization },
+			{ U"clone", RunClone },
+			{ U"component_lookup", RunComponentLookup },
+			{ U"smoothing", RunSmoothing },
+			{ U"hierarchy_lookup", RunHierarchyLookup },
+		};
+		return scenarios;
+	}
+
+	[[nodiscard]]
+	String FormatJSON(const BenchConfig& config, size_t nodeCount, const BenchReport& report)
+	{
+		JSON json;
+		json[U"benchmark"] = U"NocoBench";
+		json[U"config"] = JSON
+		{
+			{ U"depth", config.depth },
+			{ U"fanout", config.fanout },
+			{ U"layout", String{ LayoutMixToString(config.layoutMix) } },
+			{ U"components", String{ ComponentMixToString(config.componentMix) } },
+			{ U"textLength", config.textLength },
+			{ U"smoothingCount", config.smoothingCount },
+			{ U"hierarchyNodeCount", config.hierarchyNodeCount },
+			{ U"iterations", config.iterations },
+			{ U"warmup", config.warmup },
+			{ U"seed", config.seed },
+			{ U"nodeCount", static_cast<uint64>(nodeCount) },
+		};
+		json[U"results"] = Array<JSON>{};
+		for (const auto& result : report.results())
+		{
+			json[U"results"].push_back(JSON
+			{
+				{ U"scenario", result.scenario },
+				{ U"metric", result.metric },
+				{ U"value", result.value },
+				{ U"unit", result.unit },
+			});
+		}
+		return json.format();
+	}
+
+	[[nodiscard]]
+	String FormatCSV(const BenchReport& report)
+	{
+		String csv = U"scenario,metric,value,unit\n";
+		for (const auto& result : report.results())
+		{
+			csv += U"{},{},{},{}\n"_fmt(result.scenario, result.metric, result.value, result.unit);
+		}
+		return csv;
+	}
+
+	void Run(const BenchConfig& config)
+	{
+		for (const auto& name : config.scenarios)
+		{
+			if (!Scenarios().any([&](const BenchScenario& scenario) { return scenario.name == name; }))
+			{
+				throw Error{ U"Run: Unknown scenario '{}'"_fmt(name) };
+			}
+		}
+
+		BenchReport report;
+		for (const auto& scenario : Scenarios())
+		{
+			if (config.scenarios.empty() || config.scenarios.contains(String{ scenario.name }))
+			{
+				scenario.fnRun(config, report);
+			}
+		}
+
+		const size_t nodeCount = NodeCount(config);
+		const String output = config.format == OutputFormat::JSON ? FormatJSON(config, nodeCount, report) : FormatCSV(report);
+		if (config.outputPath.isEmpty())
+		{
+			std::cout << output.toUTF8() << std::endl;
+		}
+		else
+		{
+			TextWriter writer{ config.outputPath };
+			if (!writer)
+			{
+				throw Error{ U"Run: Failed to open '{}'"_fmt(config.outputPath) };
+			}
+			writer.write(output);
+		}
+	}
+}
+
+void Main()
+{
+	try
+	{
+		Run(ParseCommandLine(System::GetCommandLineArgs()));
+	}
+	catch (const Error& error)
+	{
+		// CIで失敗を検出できるよう終了コードで通知する
+		std::cerr << error.what().toUTF8() << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+}
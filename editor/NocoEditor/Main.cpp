@@ -37,6 +37,77 @@ static PropertyValue<ColorF> MenuItemRectFillColor()
 	return PropertyValue<ColorF>{ ColorF{ 0.8, 0.0 }, ColorF{ 0.8 }, ColorF{ 0.8 }, ColorF{ 0.8, 0.0 }, 0.05 };
 }
 
+// 生成済みのウィジェットを種類ごとに保持して使い回すためのプール
+// (表示のたびにノード・コンポーネントを生成・破棄しないようにする)
+template <class TWidget>
+class WidgetPool
+{
+private:
+	Array<TWidget> m_freeWidgets;
+	size_t m_acquireCount = 0;
+	size_t m_hitCount = 0;
+
+public:
+	template <class Fty>
+	[[nodiscard]]
+	TWidget acquire(Fty fnCreate)
+	{
+		++m_acquireCount;
+		if (m_freeWidgets.empty())
+		{
+			return fnCreate();
+		}
+		++m_hitCount;
+		TWidget widget = std::move(m_freeWidgets.back());
+		m_freeWidgets.pop_back();
+		return widget;
+	}
+
+	void release(TWidget widget)
+	{
+		// 前回表示時のホバー色等が次回表示の最初のフレームに残らないよう、操作の状態を破棄しておく
+		if constexpr (std::same_as<TWidget, std::shared_ptr<Node>>)
+		{
+			widget->resetInteractStateRecursive();
+		}
+		else
+		{
+			widget.node->resetInteractStateRecursive();
+		}
+		m_freeWidgets.push_back(std::move(widget));
+	}
+
+	[[nodiscard]]
+	size_t acquireCount() const
+	{
+		return m_acquireCount;
+	}
+
+	[[nodiscard]]
+	size_t hitCount() const
+	{
+		return m_hitCount;
+	}
+
+	[[nodiscard]]
+	size_t freeCount() const
+	{
+		return m_freeWidgets.size();
+	}
+};
+
+struct WidgetPoolStats
+{
+	size_t acquireCount = 0;
+	size_t hitCount = 0;
+
+	[[nodiscard]]
+	double hitRate() const
+	{
+		return acquireCount == 0 ? 0.0 : static_cast<double>(hitCount) / acquireCount;
+	}
+};
+
 class ContextMenu
 {
 public:
@@ -51,6 +122,19 @@ private:
 	Array<MenuElement> m_elements;
 	Array<std::shared_ptr<Node>> m_elementNodes;
 
+	// 項目(MenuItem・CheckableMenuItem共通)のウィジェット
+	struct ItemWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> textLabel;
+		std::shared_ptr<Label> hotKeyTextLabel;
+		std::shared_ptr<Label> checkLabel;
+	};
+	Array<ItemWidget> m_itemWidgets;
+	Array<std::shared_ptr<Node>> m_separatorNodes;
+	WidgetPool<ItemWidget> m_itemWidgetPool;
+	WidgetPool<std::shared_ptr<Node>> m_separatorNodePool;
+
 	std::function<void()> m_fnOnHide = nullptr;
 
 	bool m_isFirstUpdateSinceShown = false;
@@ -62,6 +146,81 @@ private:
 		m_screenMaskNode->setActive(ActiveYN::No, RefreshesLayoutYN::No);
 		m_rootNode->removeChildrenAll(RefreshesLayoutYN::No);
 		m_fnOnHide = nullptr;
+
+		// 次回表示時に使い回すためプールへ戻す
+		for (auto& itemWidget : m_itemWidgets)
+		{
+			m_itemWidgetPool.release(std::move(itemWidget));
+		}
+		m_itemWidgets.clear();
+		for (auto& separatorNode : m_separatorNodes)
+		{
+			m_separatorNodePool.release(std::move(separatorNode));
+		}
+		m_separatorNodes.clear();
+	}
+
+	[[nodiscard]]
+	static ItemWidget CreateItemWidget()
+	{
+		const auto itemNode = Node::Create(
+			U"MenuItem",
+			BoxConstraint
+			{
+				.sizeRatio = Vec2{ 1, 0 },
+				.sizeDelta = Vec2{ 0, MenuItemHeight },
+			},
+			IsHitTargetYN::Yes,
+			InheritChildrenStateFlags::None);
+		itemNode->emplaceComponent<RectRenderer>(MenuItemRectFillColor());
+		const auto textLabel = itemNode->emplaceComponent<Label>(U"", U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Left, VerticalAlign::Middle, LRTB{ 30, 10, 0, 0 });
+		const auto hotKeyTextLabel = itemNode->emplaceComponent<Label>(U"", U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Right, VerticalAlign::Middle, LRTB{ 0, 10, 0, 0 });
+		const auto checkLabel = itemNode->emplaceComponent<Label>(U"", U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Left, VerticalAlign::Middle, LRTB{ 10, 10, 0, 0 });
+		return ItemWidget
+		{
+			.node = itemNode,
+			.textLabel = textLabel,
+			.hotKeyTextLabel = hotKeyTextLabel,
+			.checkLabel = checkLabel,
+		};
+	}
+
+	[[nodiscard]]
+	static std::shared_ptr<Node> CreateSeparatorNode()
+	{
+		const auto separatorNode = Node::Create(
+			U"Separator",
+			BoxConstraint
+			{
+				.sizeRatio = Vec2{ 1, 0 },
+				.sizeDelta = Vec2{ 0, 8 },
+			},
+			IsHitTargetYN::No,
+			InheritChildrenStateFlags::None);
+		separatorNode->emplaceChild(
+			U"SeparatorLine",
+			AnchorConstraint
+			{
+				.anchorMin = Anchor::MiddleLeft,
+				.anchorMax = Anchor::MiddleRight,
+				.sizeDelta = Vec2{ -10, 1 },
+				.pivot = Anchor::MiddleCenter,
+			},
+			IsHitTargetYN::No)
+			->emplaceComponent<RectRenderer>(ColorF{ 0.7 });
+		return separatorNode;
+	}
+
+	void addItemWidget(StringView text, StringView hotKeyText, StringView checkText, bool interactable)
+	{
+		ItemWidget itemWidget = m_itemWidgetPool.acquire([] { return CreateItemWidget(); });
+		itemWidget.textLabel->setText(String{ text });
+		itemWidget.hotKeyTextLabel->setText(String{ hotKeyText });
+		itemWidget.checkLabel->setText(String{ checkText });
+		itemWidget.node->setInteractable(interactable);
+		m_rootNode->addChild(itemWidget.node, RefreshesLayoutYN::No);
+		m_elementNodes.push_back(itemWidget.node);
+		m_itemWidgets.push_back(std::move(itemWidget));
 	}
 
 public:
@@ -105,86 +264,25 @@ public:
 		m_elementNodes.reserve(m_elements.size());
 		m_fnOnHide = std::move(fnOnHide);
 
-		for (size_t i = 0; i < m_elements.size(); ++i)
+		for (const auto& element : m_elements)
 		{
-			if (const auto pItem = std::get_if<MenuItem>(&m_elements[i]))
+			if (const auto pItem = std::get_if<MenuItem>(&element))
 			{
 				// 項目
-				const auto itemNode = m_rootNode->emplaceChild(
-					U"MenuItem_{}"_fmt(i),
-					BoxConstraint
-					{
-						.sizeRatio = Vec2{ 1, 0 },
-						.sizeDelta = Vec2{ 0, MenuItemHeight },
-					},
-					IsHitTargetYN::Yes,
-					InheritChildrenStateFlags::None,
-					RefreshesLayoutYN::No);
-				itemNode->emplaceComponent<RectRenderer>(MenuItemRectFillColor());
-				itemNode->emplaceComponent<Label>(pItem->text, U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Left, VerticalAlign::Middle, LRTB{ 30, 10, 0, 0 });
-				if (!pItem->hotKeyText.empty())
-				{
-					itemNode->emplaceComponent<Label>(pItem->hotKeyText, U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Right, VerticalAlign::Middle, LRTB{ 0, 10, 0, 0 });
-				}
-				itemNode->setInteractable(pItem->fnIsEnabled());
-				m_elementNodes.push_back(itemNode);
+				addItemWidget(pItem->text, pItem->hotKeyText, U"", pItem->fnIsEnabled());
 			}
-			else if (const auto pCheckableItem = std::get_if<CheckableMenuItem>(&m_elements[i]))
+			else if (const auto pCheckableItem = std::get_if<CheckableMenuItem>(&element))
 			{
 				// チェック可能な項目
-				const auto itemNode = m_rootNode->emplaceChild(
-					U"CheckableMenuItem_{}"_fmt(i),
-					BoxConstraint
-					{
-						.sizeRatio = Vec2{ 1, 0 },
-						.sizeDelta = Vec2{ 0, MenuItemHeight },
-					},
-					IsHitTargetYN::Yes,
-					InheritChildrenStateFlags::None,
-					RefreshesLayoutYN::No);
-				itemNode->emplaceComponent<RectRenderer>(MenuItemRectFillColor());
-				itemNode->emplaceComponent<Label>(pCheckableItem->text, U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Left, VerticalAlign::Middle, LRTB{ 30, 10, 0, 0 });
-				if (!pCheckableItem->hotKeyText.empty())
-				{
-					itemNode->emplaceComponent<Label>(pCheckableItem->hotKeyText, U"Font14", 14, PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }), HorizontalAlign::Right, VerticalAlign::Middle, LRTB{ 0, 10, 0, 0 });
-				}
-				itemNode->emplaceComponent<Label>(
-					pCheckableItem->checked ? U"✔" : U"",
-					U"Font14",
-					14,
-					PropertyValue<ColorF>{ ColorF{ 0.0 } }.withDisabled(ColorF{ 0.5 }),
-					HorizontalAlign::Left,
-					VerticalAlign::Middle,
-					LRTB{ 10, 10, 0, 0 });
-				itemNode->setInteractable(pCheckableItem->fnIsEnabled());
-				m_elementNodes.push_back(itemNode);
-			}
-			else if (std::holds_alternative<MenuSeparator>(m_elements[i]))
+				addItemWidget(pCheckableItem->text, pCheckableItem->hotKeyText, pCheckableItem->checked ? U"✔" : U"", pCheckableItem->fnIsEnabled());
+			}
+			else if (std::holds_alternative<MenuSeparator>(element))
 			{
 				// セパレータ
-				const auto separatorNode = m_rootNode->emplaceChild(
-					U"Separator",
-					BoxConstraint
-					{
-						.sizeRatio = Vec2{ 1, 0 },
-						.sizeDelta = Vec2{ 0, 8 },
-					},
-					IsHitTargetYN::No,
-					InheritChildrenStateFlags::None,
-					RefreshesLayoutYN::No);
-				separatorNode->emplaceChild(
-					U"SeparatorLine",
-					AnchorConstraint
-					{
-						.anchorMin = Anchor::MiddleLeft,
-						.anchorMax = Anchor::MiddleRight,
-						.sizeDelta = Vec2{ -10, 1 },
-						.pivot = Anchor::MiddleCenter,
-					},
-					IsHitTargetYN::No)
-					->emplaceComponent<RectRenderer>(ColorF{ 0.7 });
-
+				const auto separatorNode = m_separatorNodePool.acquire([] { return CreateSeparatorNode(); });
+				m_rootNode->addChild(separatorNode, RefreshesLayoutYN::No);
 				m_elementNodes.push_back(separatorNode);
+				m_separatorNodes.push_back(separatorNode);
 			}
 		}
 
@@ -288,6 +386,17 @@ public:
 	{
 		return m_rootNode->isHoveredRecursive();
 	}
+
+	// 項目ウィジェットのプールの利用状況(acquireのうち再利用できた割合)
+	[[nodiscard]]
+	WidgetPoolStats poolStats() const
+	{
+		return WidgetPoolStats
+		{
+			.acquireCount = m_itemWidgetPool.acquireCount() + m_separatorNodePool.acquireCount(),
+			.hitCount = m_itemWidgetPool.hitCount() + m_separatorNodePool.hitCount(),
+		};
+	}
 };
 
 class ContextMenuOpener : public ComponentBase
@@ -416,6 +525,149 @@ public:
 	}
 };
 
+// 元に戻す・やり直しの履歴
+// (ドキュメント全体のスナップショットは取らず、操作ごとに変更箇所の差分のみをノード・コンポーネントの参照とともに保持する)
+class UndoHistory
+{
+public:
+	struct Operation
+	{
+		std::function<void()> fnUndo;
+		std::function<void()> fnRedo;
+
+		// 空でなく直前の操作と同じ対象・同じキーの場合、短時間に続いた変更(値の入力やドラッグなど)は1つの操作にまとめる
+		// (対象は所有権ごと保持するため、解放された対象のアドレスが別の対象に再利用されて誤ってまとめられることはない)
+		String coalesceKey = U"";
+		std::shared_ptr<const void> coalesceTarget = nullptr;
+
+		// 記録時に割り当てられる、この操作を適用した後のドキュメントの状態を表す値
+		uint64 revision = 0;
+	};
+
+	static constexpr size_t DefaultMaxOperationCount = 300;
+
+	static constexpr Duration CoalesceDuration = Duration{ 0.5 };
+
+private:
+	Array<Operation> m_undoStack;
+	Array<Operation> m_redoStack;
+	size_t m_maxOperationCount;
+	Stopwatch m_sinceLastRecordStopwatch;
+	uint64 m_lastRevision = 0;
+	uint64 m_baseRevision = 0; // 元に戻す操作が無い状態のドキュメントの状態
+
+public:
+	explicit UndoHistory(size_t maxOperationCount = DefaultMaxOperationCount)
+		: m_maxOperationCount{ maxOperationCount }
+	{
+		if (m_maxOperationCount == 0)
+		{
+			throw Error{ U"UndoHistory: maxOperationCount must be greater than 0" };
+		}
+	}
+
+	void record(Operation&& operation)
+	{
+		m_redoStack.clear();
+
+		if (!operation.coalesceKey.empty()
+			&& !m_undoStack.empty()
+			&& m_undoStack.back().coalesceKey == operation.coalesceKey
+			&& m_undoStack.back().coalesceTarget == operation.coalesceTarget
+			&& m_sinceLastRecordStopwatch.isStarted()
+			&& m_sinceLastRecordStopwatch.elapsed() < CoalesceDuration)
+		{
+			// 最初の変更前に戻せるよう元に戻す処理はそのままにし、やり直す処理のみ最新のものに差し替える
+			m_undoStack.back().fnRedo = std::move(operation.fnRedo);
+			m_undoStack.back().revision = ++m_lastRevision;
+		}
+		else
+		{
+			operation.revision = ++m_lastRevision;
+			m_undoStack.push_back(std::move(operation));
+
+			// 上限を超えた分は古いものから破棄(保持していたノード等もここで解放される)
+			if (m_undoStack.size() > m_maxOperationCount)
+			{
+				const size_t eraseCount = m_undoStack.size() - m_maxOperationCount;
+				m_baseRevision = m_undoStack[eraseCount - 1].revision;
+				m_undoStack.erase(m_undoStack.begin(), m_undoStack.begin() + eraseCount);
+			}
+		}
+		m_sinceLastRecordStopwatch.restart();
+	}
+
+	bool undo()
+	{
+		if (m_undoStack.empty())
+		{
+			return false;
+		}
+		Operation operation = std::move(m_undoStack.back());
+		m_undoStack.pop_back();
+		operation.fnUndo();
+		m_redoStack.push_back(std::move(operation));
+
+		// 元に戻した操作とその後の変更はまとめない
+		m_sinceLastRecordStopwatch.reset();
+		return true;
+	}
+
+	bool redo()
+	{
+		if (m_redoStack.empty())
+		{
+			return false;
+		}
+		Operation operation = std::move(m_redoStack.back());
+		m_redoStack.pop_back();
+		operation.fnRedo();
+		m_undoStack.push_back(std::move(operation));
+		m_sinceLastRecordStopwatch.reset();
+		return true;
+	}
+
+	void clear()
+	{
+		m_undoStack.clear();
+		m_redoStack.clear();
+		m_sinceLastRecordStopwatch.reset();
+		m_baseRevision = ++m_lastRevision;
+	}
+
+	[[nodiscard]]
+	bool canUndo() const
+	{
+		return !m_undoStack.empty();
+	}
+
+	[[nodiscard]]
+	bool canRedo() const
+	{
+		return !m_redoStack.empty();
+	}
+
+	[[nodiscard]]
+	size_t undoCount() const
+	{
+		return m_undoStack.size();
+	}
+
+	[[nodiscard]]
+	size_t redoCount() const
+	{
+		return m_redoStack.size();
+	}
+
+	// 現在のドキュメントの状態を表す値(保存時の値と比較して未保存の変更の有無を判定する)
+	// (操作ごとに異なる値を割り当てるため、元に戻して保存時と同じ状態になった場合は保存時と同じ値になる)
+	[[nodiscard]]
+	uint64 documentRevision() const
+	{
+		return m_undoStack.empty() ? m_baseRevision : m_undoStack.back().revision;
+	}
+};
+
 class Hierarchy
 {
 private:
@@ -428,8 +680,111 @@ private:
 	std::weak_ptr<Node> m_shiftSelectOriginNode;
 	std::weak_ptr<Node> m_lastEditorSelectedNode;
 	std::shared_ptr<ContextMenu> m_contextMenu;
+	std::shared_ptr<UndoHistory> m_undoHistory;
 	Array<JSON> m_copiedNodeJSONs;
 
+	// 親の子としての位置(ノードの追加・削除を元に戻すために使用)
+	struct NodePlacement
+	{
+		std::shared_ptr<Node> parent;
+		std::shared_ptr<Node> node;
+		size_t index = 0;
+
+		[[nodiscard]]
+		static Optional<NodePlacement> Of(const std::shared_ptr<Node>& node)
+		{
+			const auto parent = node->parent();
+			if (!parent)
+			{
+				return none;
+			}
+			const auto& siblings = parent->children();
+			const auto it = std::find(siblings.begin(), siblings.end(), node);
+			if (it == siblings.end())
+			{
+				return none;
+			}
+			return NodePlacement{ .parent = parent, .node = node, .index = static_cast<size_t>(std::distance(siblings.begin(), it)) };
+		}
+
+		void attach() const
+		{
+			parent->addChildAtIndex(node, index, RefreshesLayoutYN::No);
+		}
+
+		void detach() const
+		{
+			parent->removeChild(node, RefreshesLayoutYN::No);
+		}
+	};
+
+	// 兄弟間の入れ替え(同じ入れ替えをもう一度行うと元に戻る)
+	struct ChildSwap
+	{
+		std::shared_ptr<Node> parent;
+		size_t index1 = 0;
+		size_t index2 = 0;
+	};
+
+	void recordAddedNodes(const Array<std::shared_ptr<Node>>& addedNodes)
+	{
+		Array<NodePlacement> placements;
+		placements.reserve(addedNodes.size());
+		for (const auto& addedNode : addedNodes)
+		{
+			if (const auto placement = NodePlacement::Of(addedNode))
+			{
+				placements.push_back(*placement);
+			}
+		}
+		if (placements.empty())
+		{
+			return;
+		}
+		m_undoHistory->record(UndoHistory::Operation
+		{
+			.fnUndo = [placements]
+			{
+				for (auto it = placements.rbegin(); it != placements.rend(); ++it)
+				{
+					it->detach();
+				}
+			},
+			.fnRedo = [placements]
+			{
+				for (const auto& placement : placements)
+				{
+					placement.attach();
+				}
+			},
+		});
+	}
+
+	void recordChildSwaps(const Array<ChildSwap>& swaps)
+	{
+		if (swaps.empty())
+		{
+			return;
+		}
+		m_undoHistory->record(UndoHistory::Operation
+		{
+			.fnUndo = [swaps]
+			{
+				for (auto it = swaps.rbegin(); it != swaps.rend(); ++it)
+				{
+					it->parent->swapChildren(it->index1, it->index2, RefreshesLayoutYN::No);
+				}
+			},
+			.fnRedo = [swaps]
+			{
+				for (const auto& swap : swaps)
+				{
+					swap.parent->swapChildren(swap.index1, swap.index2, RefreshesLayoutYN::No);
+				}
+			},
+		});
+	}
+
 	struct ElementDetail
 	{
 		size_t nestLevel = 0;
@@ -449,6 +804,40 @@ private:
 		EditorSelectedYN m_editorSelected = EditorSelectedYN::No;
 		FoldedYN m_folded = FoldedYN::No;
 
+		// 状態ラベルに表示中の内容の元になった状態(変化があった場合のみラベルを更新するため)
+		struct StateLabelKey
+		{
+			bool isHitTarget = false;
+			InteractState interactState = InteractState::Default;
+			bool selected = false;
+
+			bool operator==(const StateLabelKey&) const = default;
+		};
+		Optional<StateLabelKey> m_stateLabelKey;
+
+		[[nodiscard]]
+		static const char32* StateLabelText(const StateLabelKey& key)
+		{
+			if (!key.isHitTarget)
+			{
+				return key.selected ? U"[Selected]" : U"";
+			}
+
+			switch (key.interactState)
+			{
+			case InteractState::Default:
+				return key.selected ? U"[Selected]" : U"[Default]";
+			case InteractState::Hovered:
+				return key.selected ? U"[Selected, Hovered]" : U"[Hovered]";
+			case InteractState::Pressed:
+				return key.selected ? U"[Selected, Pressed]" : U"[Pressed]";
+			case InteractState::Disabled:
+				return key.selected ? U"[Selected, Disabled]" : U"[Disabled]";
+			default:
+				throw Error{ U"Invalid InteractState: {}"_fmt(static_cast<std::underlying_type_t<InteractState>>(key.interactState)) };
+			}
+		}
+
 	public:
 		Element(Hierarchy* pHierarchy, const ElementDetail& elementDetail)
 			: m_pHierarchy{ pHierarchy }
@@ -516,6 +905,25 @@ private:
 			return m_folded;
 		}
 
+		// ノードの状態が前回から変化した場合のみ状態ラベルを更新する
+		void refreshStateLabel()
+		{
+			const auto& node = m_elementDetail.node;
+			const bool isHitTarget = node->isHitTarget().getBool();
+			const StateLabelKey key
+			{
+				.isHitTarget = isHitTarget,
+				.interactState = isHitTarget ? node->currentInteractState() : InteractState::Default,
+				.selected = node->selected().getBool(),
+			};
+			if (m_stateLabelKey == key)
+			{
+				return;
+			}
+			m_stateLabelKey = key;
+			m_elementDetail.hierarchyStateLabel->setText(StateLabelText(key));
+		}
+
 		[[nodiscard]]
 		static PropertyValue<ColorF> HierarchyRectFillColor(EditorSelectedYN editorSelected)
 		{
@@ -544,25 +952,58 @@ private:
 	};
 	Array<Element> m_elements;
 
-	void addElementRecursive(const std::shared_ptr<Node>& node, size_t nestLevel, RefreshesLayoutYN refreshesLayout)
+	// ノードからm_elements内の添字を引くための索引(m_elementsを変更した場合はrefreshElementIndex()で更新する)
+	HashTable<std::shared_ptr<Node>, size_t> m_elementIndexByNode;
+
+	void refreshElementIndex()
 	{
-		if (node == nullptr)
+		m_elementIndexByNode.clear();
+		m_elementIndexByNode.reserve(m_elements.size());
+		for (size_t i = 0; i < m_elements.size(); ++i)
 		{
-			throw Error{ U"Node is nullptr" };
+			m_elementIndexByNode.emplace(m_elements[i].node(), i);
 		}
+	}
 
-		m_elements.push_back(createElement(node, nestLevel));
-		m_hierarchyRootNode->addChild(m_elements.back().elementDetail().hierarchyNode, refreshesLayout);
-
-		for (const auto& child : node->children())
+	[[nodiscard]]
+	Optional<size_t> getElementIndexByNode(const std::shared_ptr<Node>& node) const
+	{
+		if (node == nullptr)
 		{
-			addElementRecursive(child, nestLevel + 1, refreshesLayout);
+			return none;
 		}
+		const auto it = m_elementIndexByNode.find(node);
+		if (it == m_elementIndexByNode.end())
+		{
+			return none;
+		}
+		return it->second;
 	}
 
-	Element createElement(const std::shared_ptr<Node>& node, size_t nestLevel)
+	struct NodeWithNestLevel
 	{
-		const auto hierarchyNode = Node::Create(
+		std::shared_ptr<Node> node;
+		size_t nestLevel = 0;
+	};
+
+	void collectNodesRecursive(const std::shared_ptr<Node>& node, size_t nestLevel, Array<NodeWithNestLevel>& nodes) const
+	{
+		if (node == nullptr)
+		{
+			throw Error{ U"Node is nullptr" };
+		}
+
+		nodes.push_back(NodeWithNestLevel{ .node = node, .nestLevel = nestLevel });
+
+		for (const auto& child : node->children())
+		{
+			collectNodesRecursive(child, nestLevel + 1, nodes);
+		}
+	}
+
+	Element createElement(const std::shared_ptr<Node>& node, size_t nestLevel)
+	{
+		const auto hierarchyNode = Node::Create(
 			U"Element",
 			BoxConstraint
 			{
@@ -682,23 +1123,23 @@ private:
 
 	Element* getElementByNode(const std::shared_ptr<Node>& node)
 	{
-		if (node == nullptr)
+		const auto index = getElementIndexByNode(node);
+		if (!index)
 		{
 			return nullptr;
 		}
-		const auto it = std::find_if(m_elements.begin(), m_elements.end(),
-			[node](const auto& e) { return e.node() == node; });
-		if (it == m_elements.end())
-		{
-			return nullptr;
-		}
-		return &(*it);
+		return &m_elements[*index];
 	}
 
 	void applyFoldingRecursive(Element& element, FoldedYN parentFoldedInHierarchy)
 	{
 		// 親が折り畳まれている場合はHierarchy上で非表示にする
-		element.hierarchyNode()->setActive(parentFoldedInHierarchy ? ActiveYN::No : ActiveYN::Yes);
+		// (レイアウト更新はapplyFoldingの最後にまとめて行う)
+		const bool active = !parentFoldedInHierarchy;
+		if (element.hierarchyNode()->activeSelf().getBool() != active)
+		{
+			element.hierarchyNode()->setActive(active, RefreshesLayoutYN::No);
+		}
 
 		// 再帰的に適用
 		for (auto& childNode : element.node()->children())
@@ -711,7 +1152,7 @@ private:
 	}
 
 public:
-	explicit Hierarchy(const std::shared_ptr<Canvas>& canvas, const std::shared_ptr<Canvas>& editorCanvas, const std::shared_ptr<ContextMenu>& contextMenu)
+	explicit Hierarchy(const std::shared_ptr<Canvas>& canvas, const std::shared_ptr<Canvas>& editorCanvas, const std::shared_ptr<ContextMenu>& contextMenu, const std::shared_ptr<UndoHistory>& undoHistory)
 		: m_canvas(canvas)
 		, m_hierarchyFrameNode(editorCanvas->rootNode()->emplaceChild(
 			U"HierarchyFrame",
@@ -747,6 +1188,7 @@ public:
 			}))
 		, m_editorCanvas(editorCanvas)
 		, m_contextMenu(contextMenu)
+		, m_undoHistory(undoHistory)
 	{
 		m_hierarchyFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.5, 0.4 }, Palette::Black, 0.0, 10.0);
 		m_hierarchyInnerFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.1, 0.8 }, Palette::Black, 0.0, 10.0);
@@ -764,28 +1206,103 @@ public:
 
 	void refreshNodeList()
 	{
-		Array<std::weak_ptr<Node>> foldedNodes;
-		foldedNodes.reserve(m_elements.size());
-		for (const auto& element : m_elements)
+		// 現在のノードツリーを行の並び順(深さ優先順)で列挙
+		Array<NodeWithNestLevel> nodes;
+		nodes.reserve(m_elements.size());
+		collectNodesRecursive(m_canvas->rootNode(), 0, nodes);
+
+		// 既存の行はノードごとに再利用し、追加・削除・移動のあった行のみ変更する
+		// (再利用した行の折り畳み・選択状態はそのまま引き継がれる)
+		// (行ごとのレイアウト更新は行わず、最後のapplyFoldingでまとめて1回だけ行う)
+		HashTable<std::shared_ptr<Node>, Element> reusableElements;
+		reusableElements.reserve(m_elements.size());
+		for (auto& element : m_elements)
+		{
+			const auto node = element.node();
+			reusableElements.emplace(node, std::move(element));
+		}
+		m_elements.clear();
+		m_elementIndexByNode.clear();
+
+		Array<Element> elements;
+		elements.reserve(nodes.size());
+		Array<std::shared_ptr<Node>> foldedNodes;
+		for (const auto& [node, nestLevel] : nodes)
+		{
+			const auto it = reusableElements.find(node);
+			if (it != reusableElements.end() && it->second.elementDetail().nestLevel == nestLevel)
+			{
+				elements.push_back(std::move(it->second));
+				reusableElements.erase(it);
+			}
+			else
+			{
+				if (it != reusableElements.end() && it->second.folded())
+				{
+					// 階層が変わったため作り直す行も折り畳み状態は引き継ぐ
+					foldedNodes.push_back(node);
+				}
+				elements.push_back(createElement(node, nestLevel));
+			}
+
+			const auto& toggleFoldedNode = elements.back().elementDetail().hierarchyToggleFoldedNode;
+			const bool hasChildren = node->hasChildren();
+			if (toggleFoldedNode->activeSelf().getBool() != hasChildren)
+			{
+				toggleFoldedNode->setActive(hasChildren, RefreshesLayoutYN::No);
+			}
+		}
+
+		// 削除されたノード・作り直すノードの行を取り除く
+		for (const auto& [node, element] : reusableElements)
 		{
-			if (element.folded())
+			m_hierarchyRootNode->removeChild(element.hierarchyNode(), RefreshesLayoutYN::No);
+		}
+		reusableElements.clear();
+
+		// 行の並び順をノードツリーの順序に合わせる(既に正しい位置にある行には触れない)
+		for (size_t i = 0; i < elements.size(); ++i)
+		{
+			const auto& hierarchyNode = elements[i].hierarchyNode();
+			const auto& rows = m_hierarchyRootNode->children();
+			if (i < rows.size() && rows[i] == hierarchyNode)
+			{
+				continue;
+			}
+			if (hierarchyNode->parent())
 			{
-				foldedNodes.push_back(element.node());
+				m_hierarchyRootNode->removeChild(hierarchyNode, RefreshesLayoutYN::No);
 			}
+			m_hierarchyRootNode->addChildAtIndex(hierarchyNode, i, RefreshesLayoutYN::No);
 		}
 
-		clearSelection();
-		m_elements.clear();
-		m_hierarchyRootNode->removeChildrenAll();
-		addElementRecursive(m_canvas->rootNode(), 0, RefreshesLayoutYN::Yes);
+		// m_elementsから先に取り除かれていた行など、末尾に残った不要な行を取り除く
+		while (m_hierarchyRootNode->children().size() > elements.size())
+		{
+			const auto row = m_hierarchyRootNode->children().back();
+			m_hierarchyRootNode->removeChild(row, RefreshesLayoutYN::No);
+		}
+		m_elements = std::move(elements);
+		refreshElementIndex();
+
+		// 削除されたノードを指す選択情報は破棄
+		if (getElementByNode(m_lastEditorSelectedNode.lock()) == nullptr)
+		{
+			m_lastEditorSelectedNode.reset();
+		}
+		if (getElementByNode(m_shiftSelectOriginNode.lock()) == nullptr)
+		{
+			m_shiftSelectOriginNode.reset();
+		}
 
 		for (const auto& node : foldedNodes)
 		{
-			if (auto pElement = getElementByNode(node.lock()))
+			if (auto pElement = getElementByNode(node))
 			{
 				pElement->setFolded(FoldedYN::Yes);
 			}
 		}
+		applyFolding();
 	}
 
 	void refreshNodeNames()
@@ -833,10 +1350,9 @@ public:
 	void selectSingleNode(const std::shared_ptr<Node>& node)
 	{
 		clearSelection();
-		if (auto it = std::find_if(m_elements.begin(), m_elements.end(), [&node](const Element& element) { return element.node() == node; });
-			it != m_elements.end())
+		if (auto pElement = getElementByNode(node))
 		{
-			it->setEditorSelected(EditorSelectedYN::Yes);
+			pElement->setEditorSelected(EditorSelectedYN::Yes);
 			unfoldForNode(node);
 			m_lastEditorSelectedNode = node;
 			m_shiftSelectOriginNode = node;
@@ -899,29 +1415,47 @@ public:
 				.sizeRatio = Vec2{ 0, 0 },
 				.sizeDelta = Vec2{ 100, 100 },
 			});
+		recordAddedNodes({ newNode });
 		refreshNodeList();
 		selectSingleNode(newNode);
 	}
 
 	void onClickDelete()
 	{
-		for (auto it = m_elements.begin(); it != m_elements.end();)
+		// 行の削除はrefreshNodeListで行う
+		// (元に戻せるよう、切り離したノードは親と位置とともに履歴に保持する)
+		Array<NodePlacement> removedPlacements;
+		for (const auto& element : m_elements)
 		{
-			if (it->editorSelected())
+			if (element.editorSelected())
 			{
-				if (it->node()->removeFromParent())
+				if (const auto placement = NodePlacement::Of(element.node()))
 				{
-					it = m_elements.erase(it);
-				}
-				else
-				{
-					++it;
+					element.node()->removeFromParent();
+					removedPlacements.push_back(*placement);
 				}
 			}
-			else
+		}
+		if (!removedPlacements.empty())
+		{
+			m_undoHistory->record(UndoHistory::Operation
 			{
-				++it;
-			}
+				.fnUndo = [removedPlacements]
+				{
+					// 切り離した順と逆順に戻すことで元の位置に復元する
+					for (auto it = removedPlacements.rbegin(); it != removedPlacements.rend(); ++it)
+					{
+						it->attach();
+					}
+				},
+				.fnRedo = [removedPlacements]
+				{
+					for (const auto& placement : removedPlacements)
+					{
+						placement.detach();
+					}
+				},
+			});
 		}
 		refreshNodeList();
 		clearSelection();
@@ -994,6 +1528,7 @@ public:
 			const auto newNode = parentNode->addChildFromJSON(selectedNode->toJSON(), RefreshesLayoutYN::No);
 			newNodes.push_back(newNode);
 		}
+		recordAddedNodes(newNodes);
 		m_canvas->refreshLayout();
 		refreshNodeList();
 		selectNodes(newNodes);
@@ -1038,6 +1573,7 @@ public:
 		{
 			newNodes.push_back(parentNode->addChildFromJSON(copiedNodeJSON, RefreshesLayoutYN::No));
 		}
+		recordAddedNodes(newNodes);
 		m_canvas->refreshLayout();
 		refreshNodeList();
 		selectNodes(newNodes);
@@ -1077,14 +1613,34 @@ public:
 		newParent->addChild(selectedNode);
 
 		// 元オブジェクトはアンカーがMiddleCenterのAnchorConstraintに変更する
+		const ConstraintVariant originalConstraint = selectedNode->constraint();
 		const RectF originalCalculatedRect = selectedNode->layoutAppliedRect();
-		selectedNode->setConstraint(AnchorConstraint
+		const ConstraintVariant newConstraint = AnchorConstraint
 		{
 			.anchorMin = Anchor::MiddleCenter,
 			.anchorMax = Anchor::MiddleCenter,
 			.posDelta = Vec2{ 0, 0 },
 			.sizeDelta = originalCalculatedRect.size,
 			.pivot = Anchor::MiddleCenter,
+		};
+		selectedNode->setConstraint(newConstraint);
+
+		m_undoHistory->record(UndoHistory::Operation
+		{
+			.fnUndo = [selectedNode, oldParent, newParent, idx, originalConstraint]
+			{
+				oldParent->removeChild(newParent, RefreshesLayoutYN::No);
+				newParent->removeChild(selectedNode, RefreshesLayoutYN::No);
+				selectedNode->setConstraint(originalConstraint, RefreshesLayoutYN::No);
+				oldParent->addChildAtIndex(selectedNode, idx, RefreshesLayoutYN::No);
+			},
+			.fnRedo = [selectedNode, oldParent, newParent, idx, newConstraint]
+			{
+				oldParent->removeChild(selectedNode, RefreshesLayoutYN::No);
+				oldParent->addChildAtIndex(newParent, idx, RefreshesLayoutYN::No);
+				newParent->addChild(selectedNode, RefreshesLayoutYN::No);
+				selectedNode->setConstraint(newConstraint, RefreshesLayoutYN::No);
+			},
 		});
 
 		refreshNodeList();
@@ -1117,6 +1673,7 @@ public:
 				selectionByParent[parent].push_back(child);
 			}
 		}
+		Array<ChildSwap> swaps;
 		for (auto& [parent, childrenToMove] : selectionByParent)
 		{
 			const auto& siblings = parent->children();
@@ -1140,9 +1697,11 @@ public:
 				if (index > 0)
 				{
 					parent->swapChildren(index, index - 1);
+					swaps.push_back(ChildSwap{ parent, index, index - 1 });
 				}
 			}
 		}
+		recordChildSwaps(swaps);
 		m_canvas->refreshLayout();
 		refreshNodeList();
 		selectNodes(selectedNodes);
@@ -1174,6 +1733,7 @@ public:
 				selectionByParent[parent].push_back(child);
 			}
 		}
+		Array<ChildSwap> swaps;
 		for (auto& [parent, childrenToMove] : selectionByParent)
 		{
 			const auto& siblings = parent->children();
@@ -1197,9 +1757,11 @@ public:
 				if (index < siblings.size() - 1)
 				{
 					parent->swapChildren(index, index + 1);
+					swaps.push_back(ChildSwap{ parent, index, index + 1 });
 				}
 			}
 		}
+		recordChildSwaps(swaps);
 		m_canvas->refreshLayout();
 		refreshNodeList();
 		selectNodes(selectedNodes);
@@ -1229,43 +1791,19 @@ public:
 				m_editorHoveredNode = element.node();
 			}
 
-			if (element.node()->isHitTarget())
-			{
-				const InteractState interactState = element.node()->currentInteractState();
-				switch (interactState)
-				{
-				case InteractState::Default:
-					element.elementDetail().hierarchyStateLabel->setText(element.node()->selected() ? U"[Selected]" : U"[Default]");
-					break;
-				case InteractState::Hovered:
-					element.elementDetail().hierarchyStateLabel->setText(element.node()->selected() ? U"[Selected, Hovered]" : U"[Hovered]");
-					break;
-				case InteractState::Pressed:
-					element.elementDetail().hierarchyStateLabel->setText(element.node()->selected() ? U"[Selected, Pressed]" : U"[Pressed]");
-					break;
-				case InteractState::Disabled:
-					element.elementDetail().hierarchyStateLabel->setText(element.node()->selected() ? U"[Selected, Disabled]" : U"[Disabled]");
-					break;
-				default:
-					throw Error{ U"Invalid InteractState: {}"_fmt(static_cast<std::underlying_type_t<InteractState>>(interactState)) };
-				}
-			}
-			else
-			{
-				element.elementDetail().hierarchyStateLabel->setText(element.node()->selected() ? U"[Selected]" : U"");
-			}
+			element.refreshStateLabel();
 
 			if (element.hierarchyNode()->isClicked())
 			{
 				if (KeyShift.pressed() && !m_shiftSelectOriginNode.expired())
 				{
-					const auto originIt = std::find_if(m_elements.begin(), m_elements.end(), [originNode = m_shiftSelectOriginNode.lock()](const auto& e) { return e.node() == originNode; });
-					if (originIt == m_elements.end())
+					const auto originIndexOpt = getElementIndexByNode(m_shiftSelectOriginNode.lock());
+					if (!originIndexOpt)
 					{
 						throw Error{ U"Shift select origin node not found in m_elements" };
 					}
 					clearSelection(false);
-					const auto originIndex = static_cast<size_t>(std::distance(m_elements.begin(), originIt));
+					const size_t originIndex = *originIndexOpt;
 					const auto start = Min(originIndex, i);
 					const auto end = Max(originIndex, i);
 					for (size_t j = start; j <= end; ++j)
@@ -1325,6 +1863,7 @@ public:
 		}
 		auto& rootElement = m_elements.front();
 		applyFoldingRecursive(rootElement, FoldedYN::No);
+		m_hierarchyRootNode->refreshContainedCanvasLayout();
 	}
 
 	[[nodiscard]]
@@ -1333,6 +1872,12 @@ public:
 		return m_lastEditorSelectedNode;
 	}
 
+	[[nodiscard]]
+	size_t elementCount() const
+	{
+		return m_elements.size();
+	}
+
 	const std::shared_ptr<Node>& hierarchyFrameNode() const
 	{
 		return m_hierarchyFrameNode;
@@ -1388,184 +1933,10 @@ private:
 	std::shared_ptr<Node> m_inspectorInnerFrameNode;
 	std::shared_ptr<Node> m_inspectorRootNode;
 	std::shared_ptr<ContextMenu> m_contextMenu;
+	std::shared_ptr<UndoHistory> m_undoHistory;
 	std::weak_ptr<Node> m_targetNode;
 	std::function<void()> m_onChangeNodeName;
 
-	template <class TComponent, class... Args>
-	void onClickAddComponent(Args&&... args)
-	{
-		const auto node = m_targetNode.lock();
-		if (!node)
-		{
-			return;
-		}
-		node->emplaceComponent<TComponent>(std::forward<Args>(args)...);
-		refreshInspector();
-	}
-
-public:
-	Inspector(const std::shared_ptr<Canvas>& canvas, const std::shared_ptr<Canvas>& editorCanvas, const std::shared_ptr<ContextMenu>& contextMenu, std::function<void()> onChangeNodeName)
-		: m_canvas(canvas)
-		, m_editorCanvas(editorCanvas)
-		, m_inspectorFrameNode(editorCanvas->rootNode()->emplaceChild(
-			U"InspectorFrame",
-			AnchorConstraint
-			{
-				.anchorMin = Anchor::TopRight,
-				.anchorMax = Anchor::BottomRight,
-				.posDelta = Vec2{ 0, MenuBarHeight },
-				.sizeDelta = Vec2{ 400, -MenuBarHeight },
-				.pivot = Anchor::TopRight,
-			}))
-		, m_inspectorInnerFrameNode(m_inspectorFrameNode->emplaceChild(
-			U"InspectorInnerFrame",
-			AnchorConstraint
-			{
-				.anchorMin = Anchor::TopLeft,
-				.anchorMax = Anchor::BottomRight,
-				.posDelta = Vec2{ 0, 0 },
-				.sizeDelta = Vec2{ -2, -2 },
-				.pivot = Anchor::MiddleCenter,
-			},
-			IsHitTargetYN::Yes,
-			InheritChildrenStateFlags::Pressed))
-		, m_inspectorRootNode(m_inspectorInnerFrameNode->emplaceChild(
-			U"Inspector",
-			AnchorConstraint
-			{
-				.anchorMin = Anchor::TopLeft,
-				.anchorMax = Anchor::BottomRight,
-				.posDelta = Vec2{ 0, 0 },
-				.sizeDelta = Vec2{ -10, -10 },
-				.pivot = Anchor::MiddleCenter,
-			},
-			IsHitTargetYN::Yes))
-		, m_contextMenu(contextMenu)
-		, m_onChangeNodeName(std::move(onChangeNodeName))
-	{
-		m_inspectorFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.5, 0.4 }, Palette::Black, 0.0, 10.0);
-		m_inspectorInnerFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.1, 0.8 }, Palette::Black, 0.0, 10.0);
-		m_inspectorInnerFrameNode->emplaceComponent<ContextMenuOpener>(contextMenu,
-			Array<MenuElement>
-			{
-				MenuItem{ U"Sprite を追加", U"", [this] { onClickAddComponent<Sprite>(); } },
-				MenuItem{ U"RectRenderer を追加", U"", [this] { onClickAddComponent<RectRenderer>(); } },
-				MenuItem{ U"TextBox を追加", U"", [this] { onClickAddComponent<TextBox>(); } },
-				MenuItem{ U"Label を追加", U"", [this] { onClickAddComponent<Label>(); } },
-			});
-		m_inspectorRootNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 4, 4 } });
-		m_inspectorRootNode->setVerticalScrollable(true);
-	}
-
-	void refreshInspector()
-	{
-		setTargetNode(m_targetNode.lock());
-		m_editorCanvas->refreshLayout();
-	}
-
-	void setTargetNode(const std::shared_ptr<Node>& targetNode)
-	{
-		m_targetNode = targetNode;
-
-		m_inspectorRootNode->removeChildrenAll();
-
-		if (targetNode)
-		{
-			const auto nodeNameNode = createNodeNameNode(targetNode);
-			m_inspectorRootNode->addChild(nodeNameNode);
-
-			const auto nodeSettingNode = createNodeSettingNode(targetNode);
-			m_inspectorRootNode->addChild(nodeSettingNode);
-
-			const auto constraintNode = createConstraintNode(targetNode);
-			m_inspectorRootNode->addChild(constraintNode);
-
-			const auto layoutNode = createLayoutNode(targetNode);
-			m_inspectorRootNode->addChild(layoutNode);
-
-			const auto transformEffectNode = createTransformEffectNode(&targetNode->transformEffect());
-			m_inspectorRootNode->addChild(transformEffectNode);
-
-			for (const auto& component : targetNode->components())
-			{
-				const auto componentNode = createComponentNode(targetNode, component);
-				m_inspectorRootNode->addChild(componentNode);
-			}
-		}
-	}
-
-	[[nodiscard]]
-	static std::shared_ptr<Node> CreateHeadingNode(StringView name, const ColorF& color)
-	{
-		auto headingNode = Node::Create(U"Heading", BoxConstraint
-			{
-				.sizeRatio = Vec2{ 1, 0 },
-				.sizeDelta = Vec2{ 0, 24 },
-				.margin = LRTB{ 0, 0, 0, 0 },
-			});
-		headingNode->emplaceComponent<RectRenderer>(
-			PropertyValue<ColorF>(ColorF{ color, 0.8 }).withHover(ColorF{ color + ColorF{ 0.05 }, 0.8 }).withPressed(ColorF{ color - ColorF{ 0.05 }, 0.8 }),
-			Palette::Black,
-			0.0,
-			3.0);
-		const auto arrowLabel = headingNode->emplaceComponent<Label>(
-			U"▼",
-			U"Font14Bold",
-			14,
-			ColorF{ 1.0, 0.6 },
-			HorizontalAlign::Left,
-			VerticalAlign::Middle,
-			LRTB{ 5, 5, 0, 0 },
-			HorizontalOverflow::Wrap,
-			VerticalOverflow::Clip);
-		headingNode->emplaceComponent<Label>(
-			name,
-			U"Font14Bold",
-			14,
-			Palette::White,
-			HorizontalAlign::Left,
-			VerticalAlign::Middle,
-			LRTB{ 25, 5, 0, 0 },
-			HorizontalOverflow::Wrap,
-			VerticalOverflow::Clip);
-		headingNode->addOnClick([arrowLabel](const std::shared_ptr<Node>& node)
-			{
-				if (const auto parent = node->parent())
-				{
-					bool isFolded = false;
-
-					// 見出し以外のアクティブを入れ替え
-					for (const auto child : parent->children())
-					{
-						if (child != node)
-						{
-							child->setActive(!child->activeSelf());
-							if (!child->activeSelf())
-							{
-								isFolded = true;
-							}
-						}
-					}
-
-					// 矢印を回転
-					arrowLabel->setText(isFolded ? U"▶" : U"▼");
-
-					// 折り畳み時はpaddingを付けない
-					auto layout = parent->layout();
-					if (auto pVerticalLayout = std::get_if<VerticalLayout>(&layout))
-					{
-						pVerticalLayout->padding = isFolded ? LRTB::Zero() : LRTB{ 0, 0, 0, 8 };
-					}
-					parent->setLayout(layout, RefreshesLayoutYN::No);
-
-					// 高さをフィットさせる
-					parent->setBoxConstraintToFitToChildren(FitTarget::HeightOnly, RefreshesLayoutYN::Yes);
-				}
-			});
-
-		return headingNode;
-	}
-
 	class PropertyTextBox : public ComponentBase
 	{
 	private:
@@ -1576,7 +1947,9 @@ public:
 		{
 			if (m_textBox->isChanged())
 			{
-				m_fnSetValue(m_textBox->text());
+				// 設定時にインスペクタが更新されると行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+				const auto fnSetValue = m_fnSetValue;
+				fnSetValue(m_textBox->text());
 			}
 		}
 
@@ -1591,9 +1964,911 @@ public:
 			, m_fnSetValue(std::move(fnSetValue))
 		{
 		}
-	};
 
-	[[nodiscard]]
+		void setFnSetValue(std::function<void(StringView)> fnSetValue)
+		{
+			m_fnSetValue = std::move(fnSetValue);
+		}
+	};
+
+	class Vec2PropertyTextBox : public ComponentBase
+	{
+	private:
+		std::shared_ptr<TextBox> m_textBoxX;
+		std::shared_ptr<TextBox> m_textBoxY;
+		std::function<void(const Vec2&)> m_fnSetValue;
+		Vec2 m_prevValue = Vec2::Zero();
+
+	public:
+		Vec2PropertyTextBox(
+			const std::shared_ptr<TextBox>& textBoxX,
+			const std::shared_ptr<TextBox>& textBoxY)
+			: ComponentBase{ U"Vec2PropertyTextBox", {} }
+			, m_textBoxX(textBoxX)
+			, m_textBoxY(textBoxY)
+		{
+		}
+
+		void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
+		{
+			const double x = ParseOpt<double>(m_textBoxX->text()).value_or(m_prevValue.x);
+			const double y = ParseOpt<double>(m_textBoxY->text()).value_or(m_prevValue.y);
+
+			const Vec2 newValue{ x, y };
+			if (newValue != m_prevValue)
+			{
+				m_prevValue = newValue;
+				if (m_fnSetValue)
+				{
+					// 設定時に行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+					const auto fnSetValue = m_fnSetValue;
+					fnSetValue(newValue);
+				}
+			}
+		}
+
+		void draw(const Node&) const override
+		{
+		}
+
+		void setValue(const Vec2& value)
+		{
+			m_textBoxX->setText(Format(value.x), IgnoreIsChangedYN::Yes);
+			m_textBoxY->setText(Format(value.y), IgnoreIsChangedYN::Yes);
+			m_prevValue = value;
+		}
+
+		void setFnSetValue(std::function<void(const Vec2&)> fnSetValue)
+		{
+			m_fnSetValue = std::move(fnSetValue);
+		}
+	};
+
+	class Vec4PropertyTextBox : public ComponentBase
+	{
+	private:
+		std::shared_ptr<TextBox> m_textBoxX;
+		std::shared_ptr<TextBox> m_textBoxY;
+		std::shared_ptr<TextBox> m_textBoxZ;
+		std::shared_ptr<TextBox> m_textBoxW;
+		std::function<void(const Vec4&)> m_fnSetValue;
+		Vec4 m_prevValue = Vec4::Zero();
+
+	public:
+		Vec4PropertyTextBox(
+			const std::shared_ptr<TextBox>& textBoxX,
+			const std::shared_ptr<TextBox>& textBoxY,
+			const std::shared_ptr<TextBox>& textBoxZ,
+			const std::shared_ptr<TextBox>& textBoxW)
+			: ComponentBase{ U"Vec4PropertyTextBox", {} }
+			, m_textBoxX(textBoxX)
+			, m_textBoxY(textBoxY)
+			, m_textBoxZ(textBoxZ)
+			, m_textBoxW(textBoxW)
+		{
+		}
+
+		void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
+		{
+			const double x = ParseOpt<double>(m_textBoxX->text()).value_or(m_prevValue.x);
+			const double y = ParseOpt<double>(m_textBoxY->text()).value_or(m_prevValue.y);
+			const double z = ParseOpt<double>(m_textBoxZ->text()).value_or(m_prevValue.z);
+			const double w = ParseOpt<double>(m_textBoxW->text()).value_or(m_prevValue.w);
+
+			const Vec4 newValue{ x, y, z, w };
+			if (newValue != m_prevValue)
+			{
+				m_prevValue = newValue;
+				if (m_fnSetValue)
+				{
+					// 設定時に行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+					const auto fnSetValue = m_fnSetValue;
+					fnSetValue(newValue);
+				}
+			}
+		}
+
+		void draw(const Node&) const override
+		{
+		}
+
+		void setValue(const Vec4& value)
+		{
+			m_textBoxX->setText(Format(value.x), IgnoreIsChangedYN::Yes);
+			m_textBoxY->setText(Format(value.y), IgnoreIsChangedYN::Yes);
+			m_textBoxZ->setText(Format(value.z), IgnoreIsChangedYN::Yes);
+			m_textBoxW->setText(Format(value.w), IgnoreIsChangedYN::Yes);
+			m_prevValue = value;
+		}
+
+		void setFnSetValue(std::function<void(const Vec4&)> fnSetValue)
+		{
+			m_fnSetValue = std::move(fnSetValue);
+		}
+	};
+
+	class LRTBPropertyTextBox : public ComponentBase
+	{
+	private:
+		std::shared_ptr<TextBox> m_textBoxL;
+		std::shared_ptr<TextBox> m_textBoxR;
+		std::shared_ptr<TextBox> m_textBoxT;
+		std::shared_ptr<TextBox> m_textBoxB;
+		std::function<void(const LRTB&)> m_fnSetValue;
+		LRTB m_prevValue = LRTB::Zero();
+
+	public:
+		LRTBPropertyTextBox(
+			const std::shared_ptr<TextBox>& textBoxL,
+			const std::shared_ptr<TextBox>& textBoxR,
+			const std::shared_ptr<TextBox>& textBoxT,
+			const std::shared_ptr<TextBox>& textBoxB)
+			: ComponentBase{ U"LRTBPropertyTextBox", {} }
+			, m_textBoxL(textBoxL)
+			, m_textBoxR(textBoxR)
+			, m_textBoxT(textBoxT)
+			, m_textBoxB(textBoxB)
+		{
+		}
+
+		void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
+		{
+			const double l = ParseOpt<double>(m_textBoxL->text()).value_or(m_prevValue.left);
+			const double r = ParseOpt<double>(m_textBoxR->text()).value_or(m_prevValue.right);
+			const double t = ParseOpt<double>(m_textBoxT->text()).value_or(m_prevValue.top);
+			const double b = ParseOpt<double>(m_textBoxB->text()).value_or(m_prevValue.bottom);
+			const LRTB newValue{ l, r, t, b };
+			if (newValue != m_prevValue)
+			{
+				m_prevValue = newValue;
+				if (m_fnSetValue)
+				{
+					// 設定時に行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+					const auto fnSetValue = m_fnSetValue;
+					fnSetValue(newValue);
+				}
+			}
+		}
+
+		void draw(const Node&) const override
+		{
+		}
+
+		void setValue(const LRTB& value)
+		{
+			m_textBoxL->setText(Format(value.left), IgnoreIsChangedYN::Yes);
+			m_textBoxR->setText(Format(value.right), IgnoreIsChangedYN::Yes);
+			m_textBoxT->setText(Format(value.top), IgnoreIsChangedYN::Yes);
+			m_textBoxB->setText(Format(value.bottom), IgnoreIsChangedYN::Yes);
+			m_prevValue = value;
+		}
+
+		void setFnSetValue(std::function<void(const LRTB&)> fnSetValue)
+		{
+			m_fnSetValue = std::move(fnSetValue);
+		}
+	};
+
+	class EnumPropertyComboBox : public ComponentBase
+	{
+	private:
+		String m_currentValue;
+		std::function<void(StringView)> m_onSetValue;
+		std::shared_ptr<Label> m_label;
+		std::shared_ptr<ContextMenu> m_contextMenu;
+		Array<String> m_enumCandidates;
+
+	public:
+		EnumPropertyComboBox(
+			const std::shared_ptr<Label>& label,
+			const std::shared_ptr<ContextMenu>& contextMenu)
+			: ComponentBase{ U"EnumPropertyComboBox", {} }
+			, m_label(label)
+			, m_contextMenu(contextMenu)
+		{
+		}
+
+		void update(CanvasUpdateContext*, const std::shared_ptr<Node>& node) override
+		{
+			if (node->isClicked())
+			{
+				Array<MenuElement> menuElements;
+				for (const auto& name : m_enumCandidates)
+				{
+					menuElements.push_back(
+						MenuItem
+						{
+							name,
+							U"",
+							[this, name]
+							{
+								m_currentValue = name;
+								m_label->setText(name);
+								if (m_onSetValue)
+								{
+									// 設定時に行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+									const auto onSetValue = m_onSetValue;
+									onSetValue(m_currentValue);
+								}
+							}
+						});
+				}
+				m_contextMenu->show(node->rect().bl(), menuElements);
+			}
+		}
+
+		void setValue(StringView value, const Array<String>& enumCandidates)
+		{
+			m_currentValue = value;
+			m_label->setText(m_currentValue);
+			m_enumCandidates = enumCandidates;
+		}
+
+		void setFnSetValue(std::function<void(StringView)> onSetValue)
+		{
+			m_onSetValue = std::move(onSetValue);
+		}
+	};
+
+	class CheckboxToggler : public ComponentBase
+	{
+	private:
+		bool m_value;
+		std::function<void(bool)> m_fnSetValue;
+		std::shared_ptr<Label> m_checkLabel;
+		bool m_useParentHoverState;
+
+	public:
+		CheckboxToggler(bool initialValue,
+			std::function<void(bool)> fnSetValue,
+			const std::shared_ptr<Label>& checkLabel,
+			bool useParentHoverState)
+			: ComponentBase(U"CheckboxToggler", {})
+			, m_value(initialValue)
+			, m_fnSetValue(std::move(fnSetValue))
+			, m_checkLabel(checkLabel)
+			, m_useParentHoverState(useParentHoverState)
+		{
+		}
+
+		void update(CanvasUpdateContext*, const std::shared_ptr<Node>& node) override
+		{
+			// クリックでON/OFFをトグル
+			bool isClicked = false;
+			if (m_useParentHoverState)
+			{
+				if (const auto parent = node->findHoverTargetParent())
+				{
+					isClicked = parent->isClicked();
+				}
+			}
+			else
+			{
+				isClicked = node->isClicked();
+			}
+			if (isClicked)
+			{
+				m_value = !m_value;
+				m_checkLabel->setText(m_value ? U"✓" : U"");
+				if (m_fnSetValue)
+				{
+					// 設定時に行が使い回されて関数が差し替えられる場合があるため、コピーしてから呼び出す
+					const auto fnSetValue = m_fnSetValue;
+					fnSetValue(m_value);
+				}
+			}
+		}
+
+		void setValue(bool value)
+		{
+			m_value = value;
+			m_checkLabel->setText(m_value ? U"✓" : U"");
+		}
+
+		void setFnSetValue(std::function<void(bool)> fnSetValue)
+		{
+			m_fnSetValue = std::move(fnSetValue);
+		}
+	};
+
+	// 行内のテキストボックス(プールへ戻す際に選択を解除するため、ノードと組で保持する)
+	struct RowTextBox
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<TextBox> textBox;
+	};
+
+	// 文字列で編集するプロパティの行のウィジェット
+	// (インスペクタで最も多く生成されるため、セクションを作り直す際にプールへ戻して使い回す)
+	struct PropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> nameLabel;
+		std::shared_ptr<Node> textBoxNode;
+		std::shared_ptr<TextBox> textBox;
+		std::shared_ptr<PropertyTextBox> propertyTextBox;
+	};
+
+	// 文字列以外で編集するプロパティの行のウィジェット(種類ごとに別のプールで使い回す)
+	struct Vec2PropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> nameLabel;
+		Array<RowTextBox> textBoxes;
+		std::shared_ptr<Vec2PropertyTextBox> propertyTextBox;
+	};
+
+	struct Vec4PropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> nameLabel;
+		Array<RowTextBox> textBoxes;
+		std::shared_ptr<Vec4PropertyTextBox> propertyTextBox;
+	};
+
+	struct LRTBPropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> line1NameLabel;
+		std::shared_ptr<Label> line2NameLabel;
+		Array<RowTextBox> textBoxes;
+		std::shared_ptr<LRTBPropertyTextBox> propertyTextBox;
+	};
+
+	struct EnumPropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> nameLabel;
+		std::shared_ptr<EnumPropertyComboBox> comboBox;
+	};
+
+	struct BoolPropertyRowWidget
+	{
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Label> nameLabel;
+		std::shared_ptr<CheckboxToggler> checkboxToggler;
+	};
+
+	using PooledPropertyRow = std::variant<PropertyRowWidget, Vec2PropertyRowWidget, Vec4PropertyRowWidget, LRTBPropertyRowWidget, EnumPropertyRowWidget, BoolPropertyRowWidget>;
+
+	WidgetPool<PropertyRowWidget> m_propertyRowPool;
+	WidgetPool<Vec2PropertyRowWidget> m_vec2PropertyRowPool;
+	WidgetPool<Vec4PropertyRowWidget> m_vec4PropertyRowPool;
+	WidgetPool<LRTBPropertyRowWidget> m_lrtbPropertyRowPool;
+	WidgetPool<EnumPropertyRowWidget> m_enumPropertyRowPool;
+	WidgetPool<BoolPropertyRowWidget> m_boolPropertyRowPool;
+	Array<PooledPropertyRow>* m_pCreatingSectionPropertyRows = nullptr; // 作成中のセクションが使用する行の記録先
+
+	// インスペクタに表示中の各セクション(見出し付きの枠)
+	// (対象ノードが同じ間は、項目の構成が変わったセクションと追加されたコンポーネントのセクションのみ作り直す)
+	struct Section
+	{
+		String key; // セクションの項目の構成を表すキー(構成が変わると異なる値になる)
+		std::shared_ptr<ComponentBase> component; // コンポーネントのセクションの場合のみ
+		std::shared_ptr<Node> sectionNode;
+		Array<PooledPropertyRow> propertyRows; // セクション内で使用しているプールの行(セクションの破棄時にプールへ戻す)
+		uint64 id = 0; // インスペクタでの編集がどのセクションで行われたかの識別に使用する
+		std::function<bool()> fnCheckChanged; // 控えの値(変更回数)から変わっていればtrueを返し、控えを更新する
+	};
+	Array<Section> m_sections;
+	uint64 m_nextSectionId = 1;
+	uint64 m_creatingSectionId = 0; // 作成中のセクションのID(作成中の編集用の関数に記録する)
+
+	// インスペクタで編集されたセクションのID(インスペクタ外での値の変更と区別するために使用)
+	std::shared_ptr<Array<uint64>> m_editedSectionIds = std::make_shared<Array<uint64>>();
+
+	// 前回確認した時点の編集対象のCanvasの変更回数(変わっていなければセクションごとの確認を省略する)
+	uint64 m_checkedCanvasChangeCount = 0;
+
+	// 対象の値を控えておき、変わっていればtrueを返して控えを更新する関数を作成する
+	// (fnGetValueは変更回数や小さな値のみを返すものとし、シリアライズは行わない)
+	template <class T, class Fty>
+	[[nodiscard]]
+	static std::function<bool()> CreateChangeChecker(const std::shared_ptr<T>& target, Fty fnGetValue)
+	{
+		return [weakTarget = std::weak_ptr<T>{ target }, fnGetValue, value = fnGetValue(*target)]() mutable
+			{
+				const auto lockedTarget = weakTarget.lock();
+				if (!lockedTarget)
+				{
+					return false;
+				}
+				auto currentValue = fnGetValue(*lockedTarget);
+				if (currentValue == value)
+				{
+					return false;
+				}
+				value = std::move(currentValue);
+				return true;
+			};
+	}
+
+	[[nodiscard]]
+	static String ConstraintSectionKey(const std::shared_ptr<Node>& node)
+	{
+		if (node->boxConstraint())
+		{
+			return U"Constraint:BoxConstraint";
+		}
+		else if (const auto pAnchorConstraint = node->anchorConstraint())
+		{
+			// アンカーのプリセットによって表示する項目が変わる
+			const AnchorPreset anchorPreset =
+				pAnchorConstraint->isCustomAnchorInEditor
+					? AnchorPreset::Custom
+					: ToAnchorPreset(pAnchorConstraint->anchorMin, pAnchorConstraint->anchorMax, pAnchorConstraint->pivot);
+			return U"Constraint:AnchorConstraint:{}"_fmt(EnumToString(anchorPreset));
+		}
+		else
+		{
+			throw Error{ U"Unknown constraint type" };
+		}
+	}
+
+	template <class TComponent, class... Args>
+	void onClickAddComponent(Args&&... args)
+	{
+		const auto node = m_targetNode.lock();
+		if (!node)
+		{
+			return;
+		}
+		const auto component = node->emplaceComponent<TComponent>(std::forward<Args>(args)...);
+		m_undoHistory->record(UndoHistory::Operation
+		{
+			.fnUndo = [node, component] { node->removeComponent(component); },
+			.fnRedo = [node, component] { node->addComponent(component); },
+		});
+		refreshInspector();
+	}
+
+	void onClickRemoveComponent(const std::shared_ptr<Node>& node, const std::shared_ptr<ComponentBase>& component)
+	{
+		const auto& components = node->components();
+		const auto it = std::find(components.begin(), components.end(), component);
+		if (it == components.end())
+		{
+			return;
+		}
+		const size_t index = std::distance(components.begin(), it);
+		node->removeComponent(component);
+		m_undoHistory->record(UndoHistory::Operation
+		{
+			.fnUndo = [node, component, index]
+			{
+				// 末尾に追加してから元の位置まで移動する
+				node->addComponent(component);
+				for (size_t i = node->components().size() - 1; i > index; --i)
+				{
+					node->moveComponentUp(component);
+				}
+			},
+			.fnRedo = [node, component] { node->removeComponent(component); },
+		});
+		refreshInspector();
+	}
+
+	void onClickMoveComponentUp(const std::shared_ptr<Node>& node, const std::shared_ptr<ComponentBase>& component)
+	{
+		if (node->moveComponentUp(component))
+		{
+			m_undoHistory->record(UndoHistory::Operation
+			{
+				.fnUndo = [node, component] { node->moveComponentDown(component); },
+				.fnRedo = [node, component] { node->moveComponentUp(component); },
+			});
+		}
+		refreshInspector();
+	}
+
+	void onClickMoveComponentDown(const std::shared_ptr<Node>& node, const std::shared_ptr<ComponentBase>& component)
+	{
+		if (node->moveComponentDown(component))
+		{
+			m_undoHistory->record(UndoHistory::Operation
+			{
+				.fnUndo = [node, component] { node->moveComponentUp(component); },
+				.fnRedo = [node, component] { node->moveComponentDown(component); },
+			});
+		}
+		refreshInspector();
+	}
+
+	// 履歴に記録する状態が変更前後で同じかどうか
+	template <class T>
+	[[nodiscard]]
+	static bool IsSameRecordingState(const T& before, const T& after)
+	{
+		if constexpr (std::same_as<T, TransformEffect>)
+		{
+			// 変化中の値を含むため、設定値のみを比較する
+			return before.toJSON() == after.toJSON();
+		}
+		else
+		{
+			return before == after;
+		}
+	}
+
+	// 値を設定する関数を、設定前後の状態を履歴に記録するようにラップする
+	// (fnGetStateで取得する状態は対象の項目に関わる小さな値のみとし、ドキュメント全体は保持しない)
+	template <class FtyGetState, class FtyApplyState, class FtySetValue>
+	[[nodiscard]]
+	auto makeRecordingSetter(std::shared_ptr<const void> target, StringView name, FtyGetState fnGetState, FtyApplyState fnApplyState, FtySetValue fnSetValue)
+	{
+		return
+			[undoHistory = m_undoHistory, editedSectionIds = m_editedSectionIds, sectionId = m_creatingSectionId, coalesceTarget = std::move(target), coalesceKey = String{ name }, fnGetState = std::move(fnGetState), fnApplyState = std::move(fnApplyState), fnSetValue = std::move(fnSetValue)](const auto& value)
+			{
+				// 設定時にインスペクタが更新されるとこの関数オブジェクト自体が破棄される場合があるため、使用するものは先にコピーしておく
+				const auto history = undoHistory;
+				const auto editedIds = editedSectionIds;
+				const auto editedId = sectionId;
+				const auto key = coalesceKey;
+				const auto keyTarget = coalesceTarget;
+				const auto getState = fnGetState;
+				const auto applyState = fnApplyState;
+				const auto setValue = fnSetValue;
+
+				auto beforeState = getState();
+				setValue(value);
+				editedIds->push_back(editedId);
+				auto afterState = getState();
+				if (IsSameRecordingState(beforeState, afterState))
+				{
+					// 値が変わらなかった場合(同じ値の再入力や解釈できない値など)は履歴に残さない
+					return;
+				}
+				history->record(UndoHistory::Operation
+				{
+					.fnUndo = [applyState, beforeState] { applyState(beforeState); },
+					.fnRedo = [applyState, afterState] { applyState(afterState); },
+					.coalesceKey = key,
+					.coalesceTarget = keyTarget,
+				});
+			};
+	}
+
+public:
+	Inspector(const std::shared_ptr<Canvas>& canvas, const std::shared_ptr<Canvas>& editorCanvas, const std::shared_ptr<ContextMenu>& contextMenu, const std::shared_ptr<UndoHistory>& undoHistory, std::function<void()> onChangeNodeName)
+		: m_canvas(canvas)
+		, m_editorCanvas(editorCanvas)
+		, m_inspectorFrameNode(editorCanvas->rootNode()->emplaceChild(
+			U"InspectorFrame",
+			AnchorConstraint
+			{
+				.anchorMin = Anchor::TopRight,
+				.anchorMax = Anchor::BottomRight,
+				.posDelta = Vec2{ 0, MenuBarHeight },
+				.sizeDelta = Vec2{ 400, -MenuBarHeight },
+				.pivot = Anchor::TopRight,
+			}))
+		, m_inspectorInnerFrameNode(m_inspectorFrameNode->emplaceChild(
+			U"InspectorInnerFrame",
+			AnchorConstraint
+			{
+				.anchorMin = Anchor::TopLeft,
+				.anchorMax = Anchor::BottomRight,
+				.posDelta = Vec2{ 0, 0 },
+				.sizeDelta = Vec2{ -2, -2 },
+				.pivot = Anchor::MiddleCenter,
+			},
+			IsHitTargetYN::Yes,
+			InheritChildrenStateFlags::Pressed))
+		, m_inspectorRootNode(m_inspectorInnerFrameNode->emplaceChild(
+			U"Inspector",
+			AnchorConstraint
+			{
+				.anchorMin = Anchor::TopLeft,
+				.anchorMax = Anchor::BottomRight,
+				.posDelta = Vec2{ 0, 0 },
+				.sizeDelta = Vec2{ -10, -10 },
+				.pivot = Anchor::MiddleCenter,
+			},
+			IsHitTargetYN::Yes))
+		, m_contextMenu(contextMenu)
+		, m_undoHistory(undoHistory)
+		, m_onChangeNodeName(std::move(onChangeNodeName))
+	{
+		m_inspectorFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.5, 0.4 }, Palette::Black, 0.0, 10.0);
+		m_inspectorInnerFrameNode->emplaceComponent<RectRenderer>(ColorF{ 0.1, 0.8 }, Palette::Black, 0.0, 10.0);
+		m_inspectorInnerFrameNode->emplaceComponent<ContextMenuOpener>(contextMenu,
+			Array<MenuElement>
+			{
+				MenuItem{ U"Sprite を追加", U"", [this] { onClickAddComponent<Sprite>(); } },
+				MenuItem{ U"RectRenderer を追加", U"", [this] { onClickAddComponent<RectRenderer>(); } },
+				MenuItem{ U"TextBox を追加", U"", [this] { onClickAddComponent<TextBox>(); } },
+				MenuItem{ U"Label を追加", U"", [this] { onClickAddComponent<Label>(); } },
+			});
+		m_inspectorRootNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 4, 4 } });
+		m_inspectorRootNode->setVerticalScrollable(true);
+	}
+
+	void refreshInspector()
+	{
+		setTargetNode(m_targetNode.lock());
+	}
+
+	void rebuildInspector()
+	{
+		// 表示中の値ごと作り直す(元に戻す・やり直し後など、インスペクタ外で値が変わった場合に使用)
+		m_inspectorRootNode->removeChildrenAll(RefreshesLayoutYN::No);
+		releaseSections(m_sections);
+		setTargetNode(m_targetNode.lock());
+	}
+
+	// セクション内で使用していた行をプールへ戻し、セクションを破棄する
+	void releaseSections(Array<Section>& sections)
+	{
+		for (auto& section : sections)
+		{
+			for (auto& row : section.propertyRows)
+			{
+				std::visit([this](auto& widget) { releasePropertyRow(std::move(widget)); }, row);
+			}
+		}
+		sections.clear();
+	}
+
+	// 行をセクションから外し、種類ごとのプールへ戻す
+	// (編集中のまま使い回されないよう選択を解除し、対象のノード・コンポーネントを保持し続けないよう関数を破棄する)
+	static void DetachPropertyRowNode(const std::shared_ptr<Node>& node)
+	{
+		if (const auto parent = node->parent())
+		{
+			parent->removeChild(node, RefreshesLayoutYN::No);
+		}
+	}
+
+	static void DeselectRowTextBoxes(const Array<RowTextBox>& textBoxes)
+	{
+		for (const auto& textBox : textBoxes)
+		{
+			textBox.textBox->deselect(textBox.node);
+		}
+	}
+
+	void releasePropertyRow(PropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		row.textBox->deselect(row.textBoxNode);
+		row.propertyTextBox->setFnSetValue(nullptr);
+		m_propertyRowPool.release(std::move(row));
+	}
+
+	void releasePropertyRow(Vec2PropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		DeselectRowTextBoxes(row.textBoxes);
+		row.propertyTextBox->setFnSetValue(nullptr);
+		m_vec2PropertyRowPool.release(std::move(row));
+	}
+
+	void releasePropertyRow(Vec4PropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		DeselectRowTextBoxes(row.textBoxes);
+		row.propertyTextBox->setFnSetValue(nullptr);
+		m_vec4PropertyRowPool.release(std::move(row));
+	}
+
+	void releasePropertyRow(LRTBPropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		DeselectRowTextBoxes(row.textBoxes);
+		row.propertyTextBox->setFnSetValue(nullptr);
+		m_lrtbPropertyRowPool.release(std::move(row));
+	}
+
+	void releasePropertyRow(EnumPropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		row.comboBox->setFnSetValue(nullptr);
+		m_enumPropertyRowPool.release(std::move(row));
+	}
+
+	void releasePropertyRow(BoolPropertyRowWidget row)
+	{
+		DetachPropertyRowNode(row.node);
+		row.checkboxToggler->setFnSetValue(nullptr);
+		m_boolPropertyRowPool.release(std::move(row));
+	}
+
+	// プールから取得した行を作成中のセクションに記録する(セクションの破棄時にプールへ戻す)
+	void recordCreatingSectionPropertyRow(const PooledPropertyRow& row)
+	{
+		if (m_pCreatingSectionPropertyRows)
+		{
+			m_pCreatingSectionPropertyRows->push_back(row);
+		}
+	}
+
+	void setTargetNode(const std::shared_ptr<Node>& targetNode)
+	{
+		const bool isSameTarget = targetNode != nullptr && targetNode == m_targetNode.lock();
+		m_targetNode = targetNode;
+
+		// 対象ノードが変わった場合は全セクションを作り直す
+		Array<Section> prevSections;
+		if (isSameTarget)
+		{
+			prevSections = std::move(m_sections);
+		}
+		else
+		{
+			m_inspectorRootNode->removeChildrenAll(RefreshesLayoutYN::No);
+			releaseSections(m_sections);
+		}
+		m_sections.clear();
+
+		if (targetNode)
+		{
+			Array<Section> sections;
+			const auto fnAddSection =
+				[this, &prevSections, &sections](String key, const std::shared_ptr<ComponentBase>& component, auto fnCreateChangeChecker, auto fnCreateSectionNode)
+				{
+					// 構成が同じセクションがあれば再利用する
+					const auto it = std::find_if(prevSections.begin(), prevSections.end(),
+						[&key, &component](const Section& section) { return section.key == key && section.component == component; });
+					if (it != prevSections.end())
+					{
+						sections.push_back(std::move(*it));
+						prevSections.erase(it);
+					}
+					else
+					{
+						// セクション内でプールから取得した行と、編集用の関数に記録するセクションのIDを設定しておく
+						Array<PooledPropertyRow> propertyRows;
+						const uint64 sectionId = m_nextSectionId++;
+						m_pCreatingSectionPropertyRows = &propertyRows;
+						m_creatingSectionId = sectionId;
+						auto sectionNode = fnCreateSectionNode();
+						m_pCreatingSectionPropertyRows = nullptr;
+						m_creatingSectionId = 0;
+
+						sections.push_back(Section{ .key = std::move(key), .component = component, .sectionNode = std::move(sectionNode), .propertyRows = std::move(propertyRows), .id = sectionId, .fnCheckChanged = fnCreateChangeChecker() });
+					}
+				};
+
+			// プロパティで構成される項目は変更回数で、それ以外の項目は値そのもので変更を検出する
+			fnAddSection(U"NodeName", nullptr,
+				[&] { return CreateChangeChecker(targetNode, [](const Node& node) { return std::make_pair(node.name(), node.activeSelf().getBool()); }); },
+				[&] { return createNodeNameNode(targetNode); });
+			fnAddSection(U"NodeSetting", nullptr,
+				[&]
+				{
+					return CreateChangeChecker(targetNode, [](const Node& node)
+						{
+							return std::array<bool, 7>
+							{
+								node.isHitTarget().getBool(),
+								node.inheritsChildrenHoveredState(),
+								node.inheritsChildrenPressedState(),
+								node.interactable().getBool(),
+								node.horizontalScrollable(),
+								node.verticalScrollable(),
+								node.clippingEnabled().getBool(),
+							};
+						});
+				},
+				[&] { return createNodeSettingNode(targetNode); });
+			fnAddSection(ConstraintSectionKey(targetNode), nullptr,
+				[&] { return CreateChangeChecker(targetNode, [](const Node& node) { return node.constraint(); }); },
+				[&] { return createConstraintNode(targetNode); });
+			fnAddSection(U"Layout:{}"_fmt(targetNode->layout().index()), nullptr,
+				[&] { return CreateChangeChecker(targetNode, [](const Node& node) { return node.layout(); }); },
+				[&] { return createLayoutNode(targetNode); });
+			fnAddSection(U"TransformEffect", nullptr,
+				[&] { return CreateChangeChecker(targetNode, [](const Node& node) { return node.transformEffect().changeCount(); }); },
+				[&] { return createTransformEffectNode(targetNode); });
+			for (const auto& component : targetNode->components())
+			{
+				fnAddSection(U"Component", component,
+					[&] { return CreateChangeChecker(component, [](const ComponentBase& target) { return target.changeCount(); }); },
+					[&] { return createComponentNode(targetNode, component); });
+			}
+
+			// 不要になったセクション(削除されたコンポーネント・構成の変わったセクション)を取り除く
+			for (const auto& section : prevSections)
+			{
+				m_inspectorRootNode->removeChild(section.sectionNode, RefreshesLayoutYN::No);
+			}
+			releaseSections(prevSections);
+
+			// セクションの並び順を合わせる(既に正しい位置にあるセクションには触れない)
+			for (size_t i = 0; i < sections.size(); ++i)
+			{
+				const auto& sectionNode = sections[i].sectionNode;
+				const auto& children = m_inspectorRootNode->children();
+				if (i < children.size() && children[i] == sectionNode)
+				{
+					continue;
+				}
+				if (sectionNode->parent())
+				{
+					m_inspectorRootNode->removeChild(sectionNode, RefreshesLayoutYN::No);
+				}
+				m_inspectorRootNode->addChildAtIndex(sectionNode, i, RefreshesLayoutYN::No);
+			}
+			m_sections = std::move(sections);
+		}
+
+		// レイアウト更新はまとめて1回だけ行う
+		m_inspectorRootNode->refreshContainedCanvasLayout();
+	}
+
+	[[nodiscard]]
+	static std::shared_ptr<Node> CreateHeadingNode(StringView name, const ColorF& color)
+	{
+		auto headingNode = Node::Create(U"Heading", BoxConstraint
+			{
+				.sizeRatio = Vec2{ 1, 0 },
+				.sizeDelta = Vec2{ 0, 24 },
+				.margin = LRTB{ 0, 0, 0, 0 },
+			});
+		headingNode->emplaceComponent<RectRenderer>(
+			PropertyValue<ColorF>(ColorF{ color, 0.8 }).withHover(ColorF{ color + ColorF{ 0.05 }, 0.8 }).withPressed(ColorF{ color - ColorF{ 0.05 }, 0.8 }),
+			Palette::Black,
+			0.0,
+			3.0);
+		const auto arrowLabel = headingNode->emplaceComponent<Label>(
+			U"▼",
+			U"Font14Bold",
+			14,
+			ColorF{ 1.0, 0.6 },
+			HorizontalAlign::Left,
+			VerticalAlign::Middle,
+			LRTB{ 5, 5, 0, 0 },
+			HorizontalOverflow::Wrap,
+			VerticalOverflow::Clip);
+		headingNode->emplaceComponent<Label>(
+			name,
+			U"Font14Bold",
+			14,
+			Palette::White,
+			HorizontalAlign::Left,
+			VerticalAlign::Middle,
+			LRTB{ 25, 5, 0, 0 },
+			HorizontalOverflow::Wrap,
+			VerticalOverflow::Clip);
+		headingNode->addOnClick([arrowLabel](const std::shared_ptr<Node>& node)
+			{
+				if (const auto parent = node->parent())
+				{
+					bool isFolded = false;
+
+					// 見出し以外のアクティブを入れ替え
+					for (const auto child : parent->children())
+					{
+						if (child != node)
+						{
+							child->setActive(!child->activeSelf());
+							if (!child->activeSelf())
+							{
+								isFolded = true;
+							}
+						}
+					}
+
+					// 矢印を回転
+					arrowLabel->setText(isFolded ? U"▶" : U"▼");
+
+					// 折り畳み時はpaddingを付けない
+					auto layout = parent->layout();
+					if (auto pVerticalLayout = std::get_if<VerticalLayout>(&layout))
+					{
+						pVerticalLayout->padding = isFolded ? LRTB::Zero() : LRTB{ 0, 0, 0, 8 };
+					}
+					parent->setLayout(layout, RefreshesLayoutYN::No);
+
+					// 高さをフィットさせる
+					parent->setBoxConstraintToFitToChildren(FitTarget::HeightOnly, RefreshesLayoutYN::Yes);
+				}
+			});
+
+		return headingNode;
+	}
+
+	[[nodiscard]]
 	static std::shared_ptr<Node> CreateNodeNameTextboxNode(StringView name, StringView value, std::function<void(StringView)> fnSetValue)
 	{
 		const auto propertyNode = Node::Create(
@@ -1622,10 +2897,10 @@ public:
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreatePropertyNode(StringView name, StringView value, std::function<void(StringView)> fnSetValue)
+	static PropertyRowWidget CreatePropertyRowWidget()
 	{
 		const auto propertyNode = Node::Create(
-			name,
+			U"Property",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -1642,8 +2917,8 @@ public:
 				.sizeRatio = Vec2{ 0, 1 },
 				.flexibleWeight = 0.85,
 			});
-		labelNode->emplaceComponent<Label>(
-			name,
+		const auto nameLabel = labelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -1661,19 +2936,36 @@ public:
 			});
 		textBoxNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBox = textBoxNode->emplaceComponent<TextBox>(U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBox->setText(value, IgnoreIsChangedYN::Yes);
-		textBoxNode->addComponent(std::make_shared<PropertyTextBox>(textBox, std::move(fnSetValue)));
-		return propertyNode;
+		const auto propertyTextBox = std::make_shared<PropertyTextBox>(textBox, nullptr);
+		textBoxNode->addComponent(propertyTextBox);
+		return PropertyRowWidget
+		{
+			.node = propertyNode,
+			.nameLabel = nameLabel,
+			.textBoxNode = textBoxNode,
+			.textBox = textBox,
+			.propertyTextBox = propertyTextBox,
+		};
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreateVec2PropertyNode(
-		StringView name,
-		const Vec2& currentValue,
-		std::function<void(const Vec2&)> fnSetValue)
+	std::shared_ptr<Node> createPropertyNode(StringView name, StringView value, std::function<void(StringView)> fnSetValue)
+	{
+		PropertyRowWidget row = m_propertyRowPool.acquire([] { return CreatePropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No); // 折り畳まれたセクションで使用されていた場合があるため
+		row.nameLabel->setText(String{ name });
+		row.textBox->setText(value, IgnoreIsChangedYN::Yes);
+		row.propertyTextBox->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
+	}
+
+	[[nodiscard]]
+	static Vec2PropertyRowWidget CreateVec2PropertyRowWidget()
 	{
 		const auto propertyNode = Node::Create(
-			name,
+			U"Vec2Property",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -1695,8 +2987,8 @@ public:
 				.sizeRatio = Vec2{ 0, 1 },
 				.flexibleWeight = 0.85,
 			});
-		labelNode->emplaceComponent<Label>(
-			name,
+		const auto nameLabel = labelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -1729,7 +3021,6 @@ public:
 		textBoxXNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxX = textBoxXNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxX->setText(Format(currentValue.x), IgnoreIsChangedYN::Yes);
 
 		// Y
 		const auto textBoxYNode = textBoxParentNode->emplaceChild(
@@ -1743,69 +3034,40 @@ public:
 		textBoxYNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxY = textBoxYNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxY->setText(Format(currentValue.y), IgnoreIsChangedYN::Yes);
-
-		class Vec2PropertyTextBox : public ComponentBase
-		{
-		private:
-			std::shared_ptr<TextBox> m_textBoxX;
-			std::shared_ptr<TextBox> m_textBoxY;
-			std::function<void(const Vec2&)> m_fnSetValue;
-			Vec2 m_prevValue;
-
-		public:
-			Vec2PropertyTextBox(
-				const std::shared_ptr<TextBox>& textBoxX,
-				const std::shared_ptr<TextBox>& textBoxY,
-				std::function<void(const Vec2&)> fnSetValue,
-				const Vec2& initialValue)
-				: ComponentBase{ U"Vec2PropertyTextBox", {} }
-				, m_textBoxX(textBoxX)
-				, m_textBoxY(textBoxY)
-				, m_fnSetValue(std::move(fnSetValue))
-				, m_prevValue(initialValue)
-			{
-			}
-
-			void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
-			{
-				const double x = ParseOpt<double>(m_textBoxX->text()).value_or(m_prevValue.x);
-				const double y = ParseOpt<double>(m_textBoxY->text()).value_or(m_prevValue.y);
 
-				const Vec2 newValue{ x, y };
-				if (newValue != m_prevValue)
-				{
-					m_prevValue = newValue;
-					if (m_fnSetValue)
-					{
-						m_fnSetValue(newValue);
-					}
-				}
-			}
+		const auto propertyTextBox = std::make_shared<Vec2PropertyTextBox>(textBoxX, textBoxY);
+		propertyNode->addComponent(propertyTextBox);
 
-			void draw(const Node&) const override
-			{
-			}
+		return Vec2PropertyRowWidget
+		{
+			.node = propertyNode,
+			.nameLabel = nameLabel,
+			.textBoxes = { { textBoxXNode, textBoxX }, { textBoxYNode, textBoxY } },
+			.propertyTextBox = propertyTextBox,
 		};
-
-		propertyNode->addComponent(std::make_shared<Vec2PropertyTextBox>(
-			textBoxX,
-			textBoxY,
-			fnSetValue,
-			currentValue
-		));
-
-		return propertyNode;
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreateVec4PropertyNode(
+	std::shared_ptr<Node> createVec2PropertyNode(
 		StringView name,
-		const Vec4& currentValue,
-		std::function<void(const Vec4&)> fnSetValue)
+		const Vec2& currentValue,
+		std::function<void(const Vec2&)> fnSetValue)
+	{
+		Vec2PropertyRowWidget row = m_vec2PropertyRowPool.acquire([] { return CreateVec2PropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No);
+		row.nameLabel->setText(String{ name });
+		row.propertyTextBox->setValue(currentValue);
+		row.propertyTextBox->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
+	}
+
+	[[nodiscard]]
+	static Vec4PropertyRowWidget CreateVec4PropertyRowWidget()
 	{
 		const auto propertyNode = Node::Create(
-			name,
+			U"Vec4Property",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -1826,8 +3088,8 @@ public:
 				.sizeRatio = Vec2{ 0, 1 },
 				.flexibleWeight = 0.85,
 			});
-		labelNode->emplaceComponent<Label>(
-			name,
+		const auto nameLabel = labelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -1860,7 +3122,6 @@ public:
 		textBoxXNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxX = textBoxXNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxX->setText(Format(currentValue.x), IgnoreIsChangedYN::Yes);
 
 		// Y
 		const auto textBoxYNode = textBoxParentNode->emplaceChild(
@@ -1874,7 +3135,6 @@ public:
 		textBoxYNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxY = textBoxYNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxY->setText(Format(currentValue.y), IgnoreIsChangedYN::Yes);
 
 		// Z
 		const auto textBoxZNode = textBoxParentNode->emplaceChild(
@@ -1888,7 +3148,6 @@ public:
 		textBoxZNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxZ = textBoxZNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxZ->setText(Format(currentValue.z), IgnoreIsChangedYN::Yes);
 
 		// W
 		const auto textBoxWNode = textBoxParentNode->emplaceChild(
@@ -1902,79 +3161,41 @@ public:
 		textBoxWNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxW = textBoxWNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxW->setText(Format(currentValue.w), IgnoreIsChangedYN::Yes);
-
-		class Vec4PropertyTextBox : public ComponentBase
-		{
-		private:
-			std::shared_ptr<TextBox> m_textBoxX;
-			std::shared_ptr<TextBox> m_textBoxY;
-			std::shared_ptr<TextBox> m_textBoxZ;
-			std::shared_ptr<TextBox> m_textBoxW;
-			std::function<void(const Vec4&)> m_fnSetValue;
-			Vec4 m_prevValue;
-
-		public:
-			Vec4PropertyTextBox(
-				const std::shared_ptr<TextBox>& textBoxX,
-				const std::shared_ptr<TextBox>& textBoxY,
-				const std::shared_ptr<TextBox>& textBoxZ,
-				const std::shared_ptr<TextBox>& textBoxW,
-				std::function<void(const Vec4&)> fnSetValue,
-				const Vec4& initialValue)
-				: ComponentBase{ U"Vec4PropertyTextBox", {} }
-				, m_textBoxX(textBoxX)
-				, m_textBoxY(textBoxY)
-				, m_textBoxZ(textBoxZ)
-				, m_textBoxW(textBoxW)
-				, m_fnSetValue(std::move(fnSetValue))
-				, m_prevValue(initialValue)
-			{
-			}
-
-			void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
-			{
-				const double x = ParseOpt<double>(m_textBoxX->text()).value_or(m_prevValue.x);
-				const double y = ParseOpt<double>(m_textBoxY->text()).value_or(m_prevValue.y);
-				const double z = ParseOpt<double>(m_textBoxZ->text()).value_or(m_prevValue.z);
-				const double w = ParseOpt<double>(m_textBoxW->text()).value_or(m_prevValue.w);
 
-				const Vec4 newValue{ x, y, z, w };
-				if (newValue != m_prevValue)
-				{
-					m_prevValue = newValue;
-					if (m_fnSetValue)
-					{
-						m_fnSetValue(newValue);
-					}
-				}
-			}
+		const auto propertyTextBox = std::make_shared<Vec4PropertyTextBox>(textBoxX, textBoxY, textBoxZ, textBoxW);
+		propertyNode->addComponent(propertyTextBox);
 
-			void draw(const Node&) const override
-			{
-			}
+		return Vec4PropertyRowWidget
+		{
+			.node = propertyNode,
+			.nameLabel = nameLabel,
+			.textBoxes = { { textBoxXNode, textBoxX }, { textBoxYNode, textBoxY }, { textBoxZNode, textBoxZ }, { textBoxWNode, textBoxW } },
+			.propertyTextBox = propertyTextBox,
 		};
-
-		propertyNode->addComponent(std::make_shared<Vec4PropertyTextBox>(
-			textBoxX,
-			textBoxY,
-			textBoxZ,
-			textBoxW,
-			fnSetValue,
-			currentValue));
-
-		return propertyNode;
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreateLRTBPropertyNode(
+	std::shared_ptr<Node> createVec4PropertyNode(
 		StringView name,
-		const LRTB& currentValue,
-		std::function<void(const LRTB&)> fnSetValue)
+		const Vec4& currentValue,
+		std::function<void(const Vec4&)> fnSetValue)
+	{
+		Vec4PropertyRowWidget row = m_vec4PropertyRowPool.acquire([] { return CreateVec4PropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No);
+		row.nameLabel->setText(String{ name });
+		row.propertyTextBox->setValue(currentValue);
+		row.propertyTextBox->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
+	}
+
+	[[nodiscard]]
+	static LRTBPropertyRowWidget CreateLRTBPropertyRowWidget()
 	{
 		constexpr int32 LineHeight = 32;
 		const auto propertyNode = Node::Create(
-			name,
+			U"LRTBProperty",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -2008,8 +3229,8 @@ public:
 					.sizeRatio = Vec2{ 0, 1 },
 					.flexibleWeight = 0.85,
 				});
-		line1LabelNode->emplaceComponent<Label>(
-			U"{} (left, right)"_fmt(name),
+		const auto line1NameLabel = line1LabelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -2042,7 +3263,6 @@ public:
 		textBoxLNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxL = textBoxLNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxL->setText(Format(currentValue.left), IgnoreIsChangedYN::Yes);
 
 		// R
 		const auto textBoxRNode = line1TextBoxParentNode->emplaceChild(
@@ -2056,7 +3276,6 @@ public:
 		textBoxRNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxR = textBoxRNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxR->setText(Format(currentValue.right), IgnoreIsChangedYN::Yes);
 
 		const auto line2 = propertyNode->emplaceChild(
 			U"Line2",
@@ -2077,8 +3296,8 @@ public:
 					.sizeRatio = Vec2{ 0, 1 },
 					.flexibleWeight = 0.85,
 				});
-		line2LabelNode->emplaceComponent<Label>(
-			U"{} (top, bottom)"_fmt(name),
+		const auto line2NameLabel = line2LabelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -2111,7 +3330,6 @@ public:
 		textBoxTNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxT = textBoxTNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxT->setText(Format(currentValue.top), IgnoreIsChangedYN::Yes);
 
 		// B
 		const auto textBoxBNode = line2TextBoxParentNode->emplaceChild(
@@ -2125,67 +3343,35 @@ public:
 		textBoxBNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(Palette::Skyblue).withSelectedDefault(Palette::Orange).withSmoothTime(0.05), 1.0, 4.0);
 		const auto textBoxB = textBoxBNode->emplaceComponent<TextBox>(
 			U"Font14", 14, Palette::White, Vec2{ 4, 4 }, Vec2{ 2, 2 }, Palette::White, ColorF{ Palette::Orange, 0.5 });
-		textBoxB->setText(Format(currentValue.bottom), IgnoreIsChangedYN::Yes);
-
-		class LRTBPropertyTextBox : public ComponentBase
-		{
-		private:
-			std::shared_ptr<TextBox> m_textBoxL;
-			std::shared_ptr<TextBox> m_textBoxR;
-			std::shared_ptr<TextBox> m_textBoxT;
-			std::shared_ptr<TextBox> m_textBoxB;
-			std::function<void(const LRTB&)> m_fnSetValue;
-			LRTB m_prevValue;
-
-		public:
-			LRTBPropertyTextBox(
-				const std::shared_ptr<TextBox>& textBoxL,
-				const std::shared_ptr<TextBox>& textBoxR,
-				const std::shared_ptr<TextBox>& textBoxT,
-				const std::shared_ptr<TextBox>& textBoxB,
-				std::function<void(const LRTB&)> fnSetValue,
-				const LRTB& initialValue)
-				: ComponentBase{ U"LRTBPropertyTextBox", {} }
-				, m_textBoxL(textBoxL)
-				, m_textBoxR(textBoxR)
-				, m_textBoxT(textBoxT)
-				, m_textBoxB(textBoxB)
-				, m_fnSetValue(std::move(fnSetValue))
-				, m_prevValue(initialValue)
-			{
-			}
 
-			void update(CanvasUpdateContext*, const std::shared_ptr<Node>&) override
-			{
-				const double l = ParseOpt<double>(m_textBoxL->text()).value_or(m_prevValue.left);
-				const double r = ParseOpt<double>(m_textBoxR->text()).value_or(m_prevValue.right);
-				const double t = ParseOpt<double>(m_textBoxT->text()).value_or(m_prevValue.top);
-				const double b = ParseOpt<double>(m_textBoxB->text()).value_or(m_prevValue.bottom);
-				const LRTB newValue{ l, r, t, b };
-				if (newValue != m_prevValue)
-				{
-					m_prevValue = newValue;
-					if (m_fnSetValue)
-					{
-						m_fnSetValue(newValue);
-					}
-				}
-			}
+		const auto propertyTextBox = std::make_shared<LRTBPropertyTextBox>(textBoxL, textBoxR, textBoxT, textBoxB);
+		propertyNode->addComponent(propertyTextBox);
 
-			void draw(const Node&) const override
-			{
-			}
+		return LRTBPropertyRowWidget
+		{
+			.node = propertyNode,
+			.line1NameLabel = line1NameLabel,
+			.line2NameLabel = line2NameLabel,
+			.textBoxes = { { textBoxLNode, textBoxL }, { textBoxRNode, textBoxR }, { textBoxTNode, textBoxT }, { textBoxBNode, textBoxB } },
+			.propertyTextBox = propertyTextBox,
 		};
+	}
 
-		propertyNode->addComponent(std::make_shared<LRTBPropertyTextBox>(
-			textBoxL,
-			textBoxR,
-			textBoxT,
-			textBoxB,
-			fnSetValue,
-			currentValue));
-
-		return propertyNode;
+	[[nodiscard]]
+	std::shared_ptr<Node> createLRTBPropertyNode(
+		StringView name,
+		const LRTB& currentValue,
+		std::function<void(const LRTB&)> fnSetValue)
+	{
+		LRTBPropertyRowWidget row = m_lrtbPropertyRowPool.acquire([] { return CreateLRTBPropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No);
+		row.line1NameLabel->setText(U"{} (left, right)"_fmt(name));
+		row.line2NameLabel->setText(U"{} (top, bottom)"_fmt(name));
+		row.propertyTextBox->setValue(currentValue);
+		row.propertyTextBox->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
 	}
 
 	[[nodiscard]]
@@ -2407,15 +3593,10 @@ public:
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreateEnumPropertyNode(
-		StringView name,
-		StringView currentValue,
-		std::function<void(StringView)> fnSetValue,
-		const std::shared_ptr<ContextMenu>& contextMenu,
-		const Array<String>& enumCandidates)
+	EnumPropertyRowWidget createEnumPropertyRowWidget() const
 	{
 		const auto propertyNode = Node::Create(
-			name,
+			U"EnumProperty",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -2434,8 +3615,8 @@ public:
 					.sizeRatio = Vec2{ 0, 1 },
 					.flexibleWeight = 0.85,
 				});
-		labelNode->emplaceComponent<Label>(
-			name,
+		const auto nameLabel = labelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -2453,7 +3634,7 @@ public:
 		comboBoxNode->emplaceComponent<RectRenderer>(PropertyValue<ColorF>{ ColorF{ 0.1, 0.8 } }.withDisabled(ColorF{ 0.5, 0.8 }).withSmoothTime(0.05), PropertyValue<ColorF>{ ColorF{ 1.0, 0.4 } }.withHover(ColorF{ 1.0, 0.6 }).withSmoothTime(0.05), 1.0, 4.0);
 
 		const auto enumLabel = comboBoxNode->emplaceComponent<Label>(
-			currentValue,
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -2461,62 +3642,8 @@ public:
 			VerticalAlign::Middle,
 			LRTB{ 5, 5, 5, 5 });
 
-		class EnumPropertyComboBox : public ComponentBase
-		{
-		private:
-			String m_currentValue;
-			std::function<void(StringView)> m_onSetValue;
-			std::shared_ptr<Label> m_label;
-			std::shared_ptr<ContextMenu> m_contextMenu;
-			Array<String> m_enumCandidates;
-
-		public:
-			EnumPropertyComboBox(
-				StringView initialValue,
-				std::function<void(StringView)> onSetValue,
-				const std::shared_ptr<Label>& label,
-				const std::shared_ptr<ContextMenu>& contextMenu,
-				const Array<String>& enumCandidates)
-				: ComponentBase{ U"EnumPropertyComboBox", {} }
-				, m_currentValue(initialValue)
-				, m_onSetValue(std::move(onSetValue))
-				, m_label(label)
-				, m_contextMenu(contextMenu)
-				, m_enumCandidates(enumCandidates)
-			{
-			}
-
-			void update(CanvasUpdateContext*, const std::shared_ptr<Node>& node) override
-			{
-				if (node->isClicked())
-				{
-					Array<MenuElement> menuElements;
-					for (const auto& name : m_enumCandidates)
-					{
-						menuElements.push_back(
-							MenuItem
-							{
-								name,
-								U"",
-								[this, name]
-								{
-									m_currentValue = name;
-									m_label->setText(name);
-									m_onSetValue(m_currentValue);
-								}
-							});
-					}
-					m_contextMenu->show(node->rect().bl(), menuElements);
-				}
-			}
-		};
-
-		comboBoxNode->addComponent(std::make_shared<EnumPropertyComboBox>(
-			currentValue,
-			fnSetValue,
-			enumLabel,
-			contextMenu,
-			enumCandidates));
+		const auto comboBox = std::make_shared<EnumPropertyComboBox>(enumLabel, m_contextMenu);
+		comboBoxNode->addComponent(comboBox);
 
 		comboBoxNode->emplaceComponent<Label>(
 			U"▼",
@@ -2527,7 +3654,29 @@ public:
 			VerticalAlign::Middle,
 			LRTB{ 5, 7, 5, 5 });
 
-		return propertyNode;
+		return EnumPropertyRowWidget
+		{
+			.node = propertyNode,
+			.nameLabel = nameLabel,
+			.comboBox = comboBox,
+		};
+	}
+
+	[[nodiscard]]
+	std::shared_ptr<Node> createEnumPropertyNode(
+		StringView name,
+		StringView currentValue,
+		std::function<void(StringView)> fnSetValue,
+		const Array<String>& enumCandidates)
+	{
+		EnumPropertyRowWidget row = m_enumPropertyRowPool.acquire([this] { return createEnumPropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No);
+		row.nameLabel->setText(String{ name });
+		row.comboBox->setValue(currentValue, enumCandidates);
+		row.comboBox->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
 	}
 
 	[[nodiscard]]
@@ -2555,54 +3704,6 @@ public:
 			HorizontalAlign::Center,
 			VerticalAlign::Middle);
 
-		class CheckboxToggler : public ComponentBase
-		{
-		private:
-			bool m_value;
-			std::function<void(bool)> m_fnSetValue;
-			std::shared_ptr<Label> m_checkLabel;
-			bool m_useParentHoverState;
-
-		public:
-			CheckboxToggler(bool initialValue,
-				std::function<void(bool)> fnSetValue,
-				const std::shared_ptr<Label>& checkLabel,
-				bool useParentHoverState)
-				: ComponentBase(U"CheckboxToggler", {})
-				, m_value(initialValue)
-				, m_fnSetValue(std::move(fnSetValue))
-				, m_checkLabel(checkLabel)
-				, m_useParentHoverState(useParentHoverState)
-			{
-			}
-
-			void update(CanvasUpdateContext*, const std::shared_ptr<Node>& node) override
-			{
-				// クリックでON/OFFをトグル
-				bool isClicked = false;
-				if (m_useParentHoverState)
-				{
-					if (const auto parent = node->findHoverTargetParent())
-					{
-						isClicked = parent->isClicked();
-					}
-				}
-				else
-				{
-					isClicked = node->isClicked();
-				}
-				if (isClicked)
-				{
-					m_value = !m_value;
-					m_checkLabel->setText(m_value ? U"✓" : U"");
-					if (m_fnSetValue)
-					{
-						m_fnSetValue(m_value);
-					}
-				}
-			}
-		};
-
 		checkboxNode->addComponent(std::make_shared<CheckboxToggler>(
 			initialValue,
 			std::move(fnSetValue),
@@ -2613,13 +3714,10 @@ public:
 	}
 
 	[[nodiscard]]
-	static std::shared_ptr<Node> CreateBoolPropertyNode(
-		StringView name,
-		bool currentValue,
-		std::function<void(bool)> fnSetValue)
+	static BoolPropertyRowWidget CreateBoolPropertyRowWidget()
 	{
 		auto propertyNode = Node::Create(
-			name,
+			U"BoolProperty",
 			BoxConstraint
 			{
 				.sizeRatio = Vec2{ 1, 0 },
@@ -2640,8 +3738,8 @@ public:
 				.flexibleWeight = 0.85,
 			},
 			IsHitTargetYN::No);
-		labelNode->emplaceComponent<Label>(
-			name,
+		const auto nameLabel = labelNode->emplaceComponent<Label>(
+			U"",
 			U"Font14",
 			14,
 			Palette::White,
@@ -2659,7 +3757,7 @@ public:
 				.flexibleWeight = 1,
 			},
 			IsHitTargetYN::No);
-		const auto checkboxNode = CreateCheckboxNode(currentValue, fnSetValue, true);
+		const auto checkboxNode = CreateCheckboxNode(false, nullptr, true);
 		checkboxNode->setConstraint(
 			AnchorConstraint
 			{
@@ -2671,7 +3769,28 @@ public:
 			});
 		checkboxParentNode->addChild(checkboxNode);
 
-		return propertyNode;
+		return BoolPropertyRowWidget
+		{
+			.node = propertyNode,
+			.nameLabel = nameLabel,
+			.checkboxToggler = checkboxNode->getComponent<CheckboxToggler>(),
+		};
+	}
+
+	[[nodiscard]]
+	std::shared_ptr<Node> createBoolPropertyNode(
+		StringView name,
+		bool currentValue,
+		std::function<void(bool)> fnSetValue)
+	{
+		BoolPropertyRowWidget row = m_boolPropertyRowPool.acquire([] { return CreateBoolPropertyRowWidget(); });
+		row.node->setName(name);
+		row.node->setActive(ActiveYN::Yes, RefreshesLayoutYN::No);
+		row.nameLabel->setText(String{ name });
+		row.checkboxToggler->setValue(currentValue);
+		row.checkboxToggler->setFnSetValue(std::move(fnSetValue));
+		recordCreatingSectionPropertyRow(row);
+		return row.node;
 	}
 
 	[[nodiscard]]
@@ -2688,20 +3807,27 @@ public:
 		nodeNameNode->setLayout(HorizontalLayout{ .padding = 6 });
 		nodeNameNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
 
-		nodeNameNode->addChild(CreateCheckboxNode(node->activeSelf().getBool(), [node](bool value) { node->setActive(value); }));
+		nodeNameNode->addChild(CreateCheckboxNode(node->activeSelf().getBool(),
+			makeRecordingSetter(node, U"activeSelf",
+				[node] { return node->activeSelf().getBool(); },
+				[node](bool value) { node->setActive(value); },
+				[node](bool value) { node->setActive(value); })));
 		nodeNameNode->addChild(CreateNodeNameTextboxNode(U"name", node->name(),
-			[this, node](StringView value)
-			{
-				if (value.empty())
+			makeRecordingSetter(node, U"name",
+				[node] { return node->name(); },
+				[this, node](const String& name) { node->setName(name); m_onChangeNodeName(); },
+				[this, node](StringView value)
 				{
-					node->setName(U"Node");
-				}
-				else
-				{
-					node->setName(value);
-				}
-				m_onChangeNodeName();
-			}));
+					if (value.empty())
+					{
+						node->setName(U"Node");
+					}
+					else
+					{
+						node->setName(value);
+					}
+					m_onChangeNodeName();
+				})));
 
 		return nodeNameNode;
 	}
@@ -2731,17 +3857,18 @@ public:
 				}));
 
 		const auto fnAddBoolChild =
-			[this, &nodeSettingNode](StringView name, bool currentValue, auto fnSetValue)
+			[this, &nodeSettingNode, &node](StringView name, auto fnGetValue, auto fnSetValue)
 			{
-				nodeSettingNode->addChild(CreateBoolPropertyNode(name, currentValue, fnSetValue));
+				// 各項目は値の設定がそのまま状態の復元になる
+				nodeSettingNode->addChild(createBoolPropertyNode(name, fnGetValue(), makeRecordingSetter(node, name, fnGetValue, fnSetValue, fnSetValue)));
 			};
-		fnAddBoolChild(U"isHitTarget", node->isHitTarget().getBool(), [node](bool value) { node->setIsHitTarget(value); });
-		fnAddBoolChild(U"inheritsChildrenHoveredState", node->inheritsChildrenHoveredState(), [node](bool value) { node->setInheritsChildrenHoveredState(value); });
-		fnAddBoolChild(U"inheritsChildrenPressedState", node->inheritsChildrenPressedState(), [node](bool value) { node->setInheritsChildrenPressedState(value); });
-		fnAddBoolChild(U"interactable", node->interactable().getBool(), [node](bool value) { node->setInteractable(value); });
-		fnAddBoolChild(U"horizontalScrollable", node->horizontalScrollable(), [node](bool value) { node->setHorizontalScrollable(value); });
-		fnAddBoolChild(U"verticalScrollable", node->verticalScrollable(), [node](bool value) { node->setVerticalScrollable(value); });
-		fnAddBoolChild(U"clippingEnabled", node->clippingEnabled().getBool(), [node](bool value) { node->setClippingEnabled(value); });
+		fnAddBoolChild(U"isHitTarget", [node] { return node->isHitTarget().getBool(); }, [node](bool value) { node->setIsHitTarget(value); });
+		fnAddBoolChild(U"inheritsChildrenHoveredState", [node] { return node->inheritsChildrenHoveredState(); }, [node](bool value) { node->setInheritsChildrenHoveredState(value); });
+		fnAddBoolChild(U"inheritsChildrenPressedState", [node] { return node->inheritsChildrenPressedState(); }, [node](bool value) { node->setInheritsChildrenPressedState(value); });
+		fnAddBoolChild(U"interactable", [node] { return node->interactable().getBool(); }, [node](bool value) { node->setInteractable(value); });
+		fnAddBoolChild(U"horizontalScrollable", [node] { return node->horizontalScrollable(); }, [node](bool value) { node->setHorizontalScrollable(value); });
+		fnAddBoolChild(U"verticalScrollable", [node] { return node->verticalScrollable(); }, [node](bool value) { node->setVerticalScrollable(value); });
+		fnAddBoolChild(U"clippingEnabled", [node] { return node->clippingEnabled().getBool(); }, [node](bool value) { node->setClippingEnabled(value); });
 
 		nodeSettingNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
 
@@ -2768,26 +3895,36 @@ public:
 		layoutNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 0, 8 } });
 		layoutNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
 		layoutNode->addChild(CreateHeadingNode(U"Layout (children)", ColorF{ 0.5, 0.3, 0.3 }));
+
+		// 種類の変更を含め、変更前後のレイアウトを丸ごと履歴に記録する
+		const auto fnRecording =
+			[this, &node](StringView name, auto fnSetValue)
+			{
+				return makeRecordingSetter(node, U"layout.{}"_fmt(name),
+					[node] { return node->layout(); },
+					[node](const LayoutVariant& layout) { node->setLayout(layout, RefreshesLayoutYN::No); },
+					std::move(fnSetValue));
+			};
 		const auto fnAddChild =
-			[&layoutNode](StringView name, const auto& value, auto fnSetValue)
+			[this, &layoutNode, &fnRecording](StringView name, const auto& value, auto fnSetValue)
 			{
-				layoutNode->addChild(CreatePropertyNode(name, Format(value), fnSetValue));
+				layoutNode->addChild(createPropertyNode(name, Format(value), fnRecording(name, std::move(fnSetValue))));
 			};
 		const auto fnAddVec2Child =
-			[&layoutNode](StringView name, const Vec2& currentValue, auto fnSetValue)
+			[this, &layoutNode, &fnRecording](StringView name, const Vec2& currentValue, auto fnSetValue)
 			{
-				layoutNode->addChild(CreateVec2PropertyNode(name, currentValue, fnSetValue));
+				layoutNode->addChild(createVec2PropertyNode(name, currentValue, fnRecording(name, std::move(fnSetValue))));
 			};
 		const auto fnAddLRTBChild =
-			[&layoutNode](StringView name, const LRTB& currentValue, auto fnSetValue)
+			[this, &layoutNode, &fnRecording](StringView name, const LRTB& currentValue, auto fnSetValue)
 			{
-				layoutNode->addChild(CreateLRTBPropertyNode(name, currentValue, fnSetValue));
+				layoutNode->addChild(createLRTBPropertyNode(name, currentValue, fnRecording(name, std::move(fnSetValue))));
 			};
 		const auto fnAddEnumChild =
-			[this, &layoutNode]<typename EnumType>(const String & name, EnumType currentValue, auto fnSetValue)
+			[this, &layoutNode, &fnRecording]<typename EnumType>(const String & name, EnumType currentValue, auto fnSetValue)
 			{
 				auto fnSetEnumValue = [fnSetValue = std::move(fnSetValue), currentValue](StringView value) { fnSetValue(StringToEnum<EnumType>(value, currentValue)); };
-				layoutNode->addChild(CreateEnumPropertyNode(name, EnumToString(currentValue), fnSetEnumValue, m_contextMenu, EnumNames<EnumType>()));
+				layoutNode->addChild(createEnumPropertyNode(name, EnumToString(currentValue), fnRecording(name, std::move(fnSetEnumValue)), EnumNames<EnumType>()));
 			};
 		if (const auto pFlowLayout = node->flowLayout())
 		{
@@ -2892,26 +4029,35 @@ public:
 
 		constraintNode->addChild(CreateHeadingNode(U"Constraint", ColorF{ 0.5, 0.3, 0.3 }));
 
+		// 種類やアンカーのプリセットの変更を含め、変更前後の制約を丸ごと履歴に記録する
+		const auto fnRecording =
+			[this, &node](StringView name, auto fnSetValue)
+			{
+				return makeRecordingSetter(node, U"constraint.{}"_fmt(name),
+					[node] { return node->constraint(); },
+					[node](const ConstraintVariant& constraint) { node->setConstraint(constraint, RefreshesLayoutYN::No); },
+					std::move(fnSetValue));
+			};
 		const auto fnAddChild =
-			[&constraintNode](StringView name, const auto& value, auto fnSetValue)
+			[this, &constraintNode, &fnRecording](StringView name, const auto& value, auto fnSetValue)
 			{
-				constraintNode->addChild(CreatePropertyNode(name, Format(value), fnSetValue));
+				constraintNode->addChild(createPropertyNode(name, Format(value), fnRecording(name, std::move(fnSetValue))));
 			};
 		const auto fnAddDoubleChild =
-			[&constraintNode](StringView name, double currentValue, auto fnSetValue)
+			[this, &constraintNode, &fnRecording](StringView name, double currentValue, auto fnSetValue)
 			{
-				constraintNode->addChild(CreatePropertyNode(name, Format(currentValue), [fnSetValue = std::move(fnSetValue)](StringView value) { fnSetValue(ParseOpt<double>(value).value_or(0.0)); }));
+				constraintNode->addChild(createPropertyNode(name, Format(currentValue), fnRecording(name, [fnSetValue = std::move(fnSetValue)](StringView value) { fnSetValue(ParseOpt<double>(value).value_or(0.0)); })));
 			};
 		const auto fnAddEnumChild =
-			[this, &constraintNode]<typename EnumType>(const String & name, EnumType currentValue, auto fnSetValue)
+			[this, &constraintNode, &fnRecording]<typename EnumType>(const String & name, EnumType currentValue, auto fnSetValue)
 			{
 				auto fnSetEnumValue = [fnSetValue = std::move(fnSetValue), currentValue](StringView value) { fnSetValue(StringToEnum<EnumType>(value, currentValue)); };
-				constraintNode->addChild(CreateEnumPropertyNode(name, EnumToString(currentValue), fnSetEnumValue, m_contextMenu, EnumNames<EnumType>()));
+				constraintNode->addChild(createEnumPropertyNode(name, EnumToString(currentValue), fnRecording(name, std::move(fnSetEnumValue)), EnumNames<EnumType>()));
 			};
 		const auto fnAddVec2Child =
-			[&constraintNode](StringView name, const Vec2& currentValue, auto fnSetValue)
+			[this, &constraintNode, &fnRecording](StringView name, const Vec2& currentValue, auto fnSetValue)
 			{
-				constraintNode->addChild(CreateVec2PropertyNode(name, currentValue, fnSetValue));
+				constraintNode->addChild(createVec2PropertyNode(name, currentValue, fnRecording(name, std::move(fnSetValue))));
 			};
 
 		if (const auto pBoxConstraint = node->boxConstraint())
@@ -3286,144 +4432,509 @@ public:
 				break;
 			}
 		}
-		else
+		else
+		{
+			throw Error{ U"Unknown constraint type" };
+		}
+
+		constraintNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+
+		return constraintNode;
+	}
+
+	[[nodiscard]]
+	std::shared_ptr<Node> createTransformEffectNode(const std::shared_ptr<Node>& node)
+	{
+		TransformEffect* const pTransformEffect = &node->transformEffect();
+
+		auto transformEffectNode = Node::Create(
+			U"TransformEffect",
+			BoxConstraint
+			{
+				.sizeRatio = Vec2{ 1, 0 },
+				.margin = LRTB{ 0, 0, 0, 8 },
+			});
+		transformEffectNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 0, 8 } });
+		transformEffectNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
+
+		transformEffectNode->addChild(CreateHeadingNode(U"TransformEffect", ColorF{ 0.3, 0.5, 0.3 }));
+
+		// 変更前後のTransformEffectを丸ごと履歴に記録する
+		const auto fnRecording =
+			[this, &node](StringView name, auto fnSetValue)
+			{
+				return makeRecordingSetter(node, U"transformEffect.{}"_fmt(name),
+					[node] { return node->transformEffect(); },
+					[node](const TransformEffect& transformEffect) { node->transformEffect() = transformEffect; },
+					std::move(fnSetValue));
+			};
+		const auto fnAddChild =
+			[this, &transformEffectNode, &fnRecording](StringView name, const SmoothProperty<double>& currentValue, auto fnSetValue)
+			{
+				transformEffectNode->addChild(createPropertyNode(name, currentValue.propertyValueString(), fnRecording(name, [fnSetValue](StringView value) { fnSetValue(ParseOr<double>(value, 0.0)); })));
+			};
+		const auto fnAddVec2Child =
+			[this, &transformEffectNode, &fnRecording](StringView name, const SmoothProperty<Vec2>& currentValue, auto fnSetValue)
+			{
+				// TODO: hovered/pressed/selectedの値を入出力可能にする
+				transformEffectNode->addChild(createVec2PropertyNode(name, currentValue.propertyValue().defaultValue, fnRecording(name, std::move(fnSetValue))));
+			};
+		fnAddVec2Child(U"position", pTransformEffect->position(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setPosition(value); m_canvas->refreshLayout(); });
+		fnAddVec2Child(U"scale", pTransformEffect->scale(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setScale(value); m_canvas->refreshLayout(); });
+		fnAddVec2Child(U"pivot", pTransformEffect->pivot(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setPivot(value); m_canvas->refreshLayout(); });
+		fnAddChild(U"rotation", pTransformEffect->rotation(), [this, pTransformEffect](double value) { pTransformEffect->setRotation(value); m_canvas->refreshLayout(); });
+
+		transformEffectNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+
+		return transformEffectNode;
+	}
+
+	[[nodiscard]]
+	std::shared_ptr<Node> createComponentNode(const std::shared_ptr<Node>& node, const std::shared_ptr<ComponentBase>& component)
+	{
+		auto componentNode = Node::Create(
+			component->type(),
+			BoxConstraint
+			{
+				.sizeRatio = Vec2{ 1, 0 },
+				.margin = LRTB{ 0, 0, 0, 8 },
+			});
+		componentNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 0, 8 } });
+		componentNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
+
+		const auto headingNode = componentNode->addChild(CreateHeadingNode(component->type(), ColorF{ 0.3, 0.3, 0.5 }));
+		headingNode->emplaceComponent<ContextMenuOpener>(
+			m_contextMenu,
+			Array<MenuElement>
+			{
+				MenuItem{ U"{} を削除"_fmt(component->type()), U"", [this, node, component] { onClickRemoveComponent(node, component); } },
+				MenuItem{ U"{} を上へ移動"_fmt(component->type()), U"", [this, node, component] { onClickMoveComponentUp(node, component); } },
+				MenuItem{ U"{} を下へ移動"_fmt(component->type()), U"", [this, node, component] { onClickMoveComponentDown(node, component); } },
+			});
+
+		for (const auto& property : component->properties())
+		{
+			// プロパティ値の文字列表現を変更前後の状態として履歴に記録する
+			// (コンポーネントは参照を保持し、削除後に元に戻された場合も同じインスタンスを対象とする)
+			const auto fnRecording =
+				[this, &component, property](auto fnSetValue)
+				{
+					return makeRecordingSetter(component, property->name(),
+						[component, property] { return property->propertyValueString(); },
+						[component, property](const String& value) { property->trySetPropertyValueString(value); },
+						std::move(fnSetValue));
+				};
+
+			switch (property->editType())
+			{
+			case PropertyEditType::Text:
+				componentNode->addChild(
+					createPropertyNode(
+						property->name(),
+						property->propertyValueString(),
+						fnRecording([property](StringView value) { property->trySetPropertyValueString(value); })));
+				break;
+			case PropertyEditType::Bool:
+				componentNode->addChild(
+					createBoolPropertyNode(
+						property->name(),
+						ParseOr<bool>(property->propertyValueString(), false),
+						fnRecording([property](bool value) { property->trySetPropertyValueString(Format(value)); })));
+				break;
+			case PropertyEditType::Vec2:
+				componentNode->addChild(
+					createVec2PropertyNode(
+						property->name(),
+						ParseOr<Vec2>(property->propertyValueString(), Vec2{ 0, 0 }),
+						fnRecording([property](const Vec2& value) { property->trySetPropertyValueString(Format(value)); })));
+				break;
+			case PropertyEditType::Color:
+				componentNode->addChild(
+					CreateColorPropertyNode(
+						property->name(),
+						ParseOr<ColorF>(property->propertyValueString(), ColorF{ 0, 0, 0, 1 }),
+						fnRecording([property](const ColorF& value) { property->trySetPropertyValueString(Format(value)); })));
+				break;
+			case PropertyEditType::LRTB:
+				componentNode->addChild(
+					createLRTBPropertyNode(
+						property->name(),
+						ParseOr<LRTB>(property->propertyValueString(), LRTB{ 0, 0, 0, 0 }),
+						fnRecording([property](const LRTB& value) { property->trySetPropertyValueString(Format(value)); })));
+				break;
+			case PropertyEditType::Enum:
+				componentNode->addChild(
+					createEnumPropertyNode(
+						property->name(),
+						property->propertyValueString(),
+						fnRecording([property](StringView value) { property->trySetPropertyValueString(value); }),
+						property->enumCandidates()));
+				break;
+			}
+		}
+
+		componentNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+
+		return componentNode;
+	}
+
+	void clearTargetNode()
+	{
+		setTargetNode(nullptr);
+	}
+
+	void update()
+	{
+		// インスペクタ外(キャンバス上でのドラッグ等)で値が変わったセクションを作り直す
+		// (インスペクタで編集したセクションは表示中の値と一致しているため、控えの値を更新するのみとする)
+		// (編集対象のCanvasの変更回数が変わっていないフレームでは、セクションごとの確認も行わない)
+		const uint64 canvasChangeCount = m_canvas->changeCount();
+		const bool canvasChanged = canvasChangeCount != m_checkedCanvasChangeCount;
+		m_checkedCanvasChangeCount = canvasChangeCount;
+		if (!canvasChanged && m_editedSectionIds->empty())
+		{
+			return;
+		}
+
+		bool hasStaleSection = false;
+		for (auto& section : m_sections)
+		{
+			const bool editedInInspector = m_editedSectionIds->contains(section.id);
+			if (!canvasChanged && !editedInInspector)
+			{
+				continue;
+			}
+			if (section.fnCheckChanged() && !editedInInspector)
+			{
+				// キーを空にして再利用の対象から外す
+				section.key.clear();
+				hasStaleSection = true;
+			}
+		}
+		m_editedSectionIds->clear();
+
+		if (hasStaleSection)
+		{
+			refreshInspector();
+		}
+	}
+
+	[[nodiscard]]
+	const std::shared_ptr<Node>& inspectorFrameNode() const
+	{
+		return m_inspectorFrameNode;
+	}
+
+	// プロパティの行のプール(全種類の合計)の利用状況(acquireのうち再利用できた割合)
+	[[nodiscard]]
+	WidgetPoolStats poolStats() const
+	{
+		return WidgetPoolStats
+		{
+			.acquireCount = m_propertyRowPool.acquireCount()
+				+ m_vec2PropertyRowPool.acquireCount()
+				+ m_vec4PropertyRowPool.acquireCount()
+				+ m_lrtbPropertyRowPool.acquireCount()
+				+ m_enumPropertyRowPool.acquireCount()
+				+ m_boolPropertyRowPool.acquireCount(),
+			.hitCount = m_propertyRowPool.hitCount()
+				+ m_vec2PropertyRowPool.hitCount()
+				+ m_vec4PropertyRowPool.hitCount()
+				+ m_lrtbPropertyRowPool.hitCount()
+				+ m_enumPropertyRowPool.hitCount()
+				+ m_boolPropertyRowPool.hitCount(),
+		};
+	}
+};
+
+// ドキュメントの保存をワーカースレッドで行う
+// (メインスレッドではノードツリーをJSONに変換するのみとし、文字列化・書き込み・ファイルの置き換えはワーカースレッドで行う)
+class DocumentSaver
+{
+public:
+	struct Result
+	{
+		FilePath filePath;
+		bool isAutosave = false;
+		bool succeeded = false;
+		uint64 documentRevision = 0; // 保存した内容のドキュメントの状態
+	};
+
+private:
+	struct Request
+	{
+		JSON json;
+		FilePath filePath;
+		bool isAutosave = false;
+		uint64 documentRevision = 0;
+	};
+
+	// 書き込みの単位(この単位ごとに進捗を更新する)
+	static constexpr size_t WriteChunkSize = 1024 * 1024;
+
+	AsyncTask<bool> m_task;
+	Optional<Request> m_runningRequest;
+	Optional<Request> m_pendingRequest;
+	std::shared_ptr<std::atomic<double>> m_progress = std::make_shared<std::atomic<double>>(0.0);
+
+	// 一時ファイルへ書き込んだ後に置き換えることで、書き込み途中で失敗しても既存のファイルを壊さないようにする
+	static bool WriteAtomically(const JSON& json, const FilePath& filePath, std::atomic<double>& progress)
+	{
+		const std::string utf8 = json.formatUTF8();
+		progress = 0.3;
+
+		std::error_code errorCode;
+		const std::filesystem::path path{ filePath.toWstr() };
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path(), errorCode);
+		}
+
+		const FilePath tempFilePath = filePath + U".tmp";
+		{
+			BinaryWriter writer{ tempFilePath };
+			if (!writer)
+			{
+				return false;
+			}
+			for (size_t offset = 0; offset < utf8.size(); offset += WriteChunkSize)
+			{
+				const size_t size = Min(WriteChunkSize, utf8.size() - offset);
+				if (writer.write(utf8.data() + offset, size) != static_cast<int64>(size))
+				{
+					writer.close();
+					FileSystem::Remove(tempFilePath);
+					return false;
+				}
+				progress = 0.3 + 0.6 * static_cast<double>(offset + size) / utf8.size();
+			}
+		}
+
+		std::filesystem::rename(std::filesystem::path{ tempFilePath.toWstr() }, path, errorCode);
+		if (errorCode)
+		{
+			FileSystem::Remove(tempFilePath);
+			return false;
+		}
+		progress = 1.0;
+		return true;
+	}
+
+	void startRequest(Request&& request)
+	{
+		*m_progress = 0.0;
+		m_task = Async(
+			[json = std::move(request.json), filePath = request.filePath, progress = m_progress]
+			{
+				return WriteAtomically(json, filePath, *progress);
+			});
+		m_runningRequest = std::move(request);
+	}
+
+public:
+	// 保存を要求する(保存中の場合は、現在の保存の完了後に最新の要求のみを実行する)
+	void requestSave(JSON&& json, const FilePath& filePath, bool isAutosave, uint64 documentRevision)
+	{
+		Request request{ .json = std::move(json), .filePath = filePath, .isAutosave = isAutosave, .documentRevision = documentRevision };
+		if (isBusy())
+		{
+			// 手動保存の要求を自動保存で上書きしない
+			if (!(isAutosave && m_pendingRequest && !m_pendingRequest->isAutosave))
+			{
+				m_pendingRequest = std::move(request);
+			}
+			return;
+		}
+		startRequest(std::move(request));
+	}
+
+	// 完了した保存の結果を返す(毎フレーム呼び出す)
+	[[nodiscard]]
+	Optional<Result> update()
+	{
+		if (!m_runningRequest || !m_task.isReady())
+		{
+			return none;
+		}
+
+		const Result result{ .filePath = m_runningRequest->filePath, .isAutosave = m_runningRequest->isAutosave, .succeeded = m_task.get(), .documentRevision = m_runningRequest->documentRevision };
+		m_runningRequest.reset();
+		if (m_pendingRequest)
 		{
-			throw Error{ U"Unknown constraint type" };
+			startRequest(std::move(*m_pendingRequest));
+			m_pendingRequest.reset();
 		}
+		return result;
+	}
 
-		constraintNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+	[[nodiscard]]
+	bool isBusy() const
+	{
+		return m_runningRequest.has_value();
+	}
 
-		return constraintNode;
+	[[nodiscard]]
+	bool isAutosaving() const
+	{
+		return m_runningRequest && m_runningRequest->isAutosave;
 	}
 
+	// 実行中または待機中の手動保存の要求があるか
 	[[nodiscard]]
-	std::shared_ptr<Node> createTransformEffectNode(TransformEffect* const pTransformEffect)
+	bool hasManualSaveRequest() const
 	{
-		auto transformEffectNode = Node::Create(
-			U"TransformEffect",
-			BoxConstraint
-			{
-				.sizeRatio = Vec2{ 1, 0 },
-				.margin = LRTB{ 0, 0, 0, 8 },
-			});
-		transformEffectNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 0, 8 } });
-		transformEffectNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
+		return (m_runningRequest && !m_runningRequest->isAutosave) || (m_pendingRequest && !m_pendingRequest->isAutosave);
+	}
 
-		transformEffectNode->addChild(CreateHeadingNode(U"TransformEffect", ColorF{ 0.3, 0.5, 0.3 }));
+	[[nodiscard]]
+	double progress() const
+	{
+		return *m_progress;
+	}
+};
 
-		const auto fnAddChild =
-			[&transformEffectNode](StringView name, const SmoothProperty<double>& currentValue, auto fnSetValue)
-			{
-				transformEffectNode->addChild(CreatePropertyNode(name, currentValue.propertyValueString(), [fnSetValue](StringView value) { fnSetValue(ParseOr<double>(value, 0.0)); }));
-			};
-		const auto fnAddVec2Child =
-			[&transformEffectNode](StringView name, const SmoothProperty<Vec2>& currentValue, auto fnSetValue)
-			{
-				// TODO: hovered/pressed/selectedの値を入出力可能にする
-				transformEffectNode->addChild(CreateVec2PropertyNode(name, currentValue.propertyValue().defaultValue, fnSetValue));
-			};
-		fnAddVec2Child(U"position", pTransformEffect->position(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setPosition(value); m_canvas->refreshLayout(); });
-		fnAddVec2Child(U"scale", pTransformEffect->scale(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setScale(value); m_canvas->refreshLayout(); });
-		fnAddVec2Child(U"pivot", pTransformEffect->pivot(), [this, pTransformEffect](const Vec2& value) { pTransformEffect->setPivot(value); m_canvas->refreshLayout(); });
-		fnAddChild(U"rotation", pTransformEffect->rotation(), [this, pTransformEffect](double value) { pTransformEffect->setRotation(value); m_canvas->refreshLayout(); });
+// ドキュメントの読み込みをワーカースレッドで行う
+// (JSONの解析とノードツリーの構築はCanvasに属さないツリーとしてワーカースレッドで行い、メインスレッドでは構築済みのツリーを設定するのみとする)
+class DocumentLoader
+{
+public:
+	enum class Status : uint8
+	{
+		Succeeded,
+		FailedToLoadFile,
+		FailedToReadData,
+		Canceled,
+	};
 
-		transformEffectNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+	struct Result
+	{
+		FilePath filePath;
+		Status status = Status::Succeeded;
+		std::shared_ptr<Node> rootNode; // 成功時のみ
+		double loadJSONMillisec = 0.0;
+		double buildNodesMillisec = 0.0;
+	};
 
-		return transformEffectNode;
-	}
+private:
+	struct SharedState
+	{
+		std::atomic<double> progress{ 0.0 };
+		std::atomic<bool> canceled{ false };
+	};
 
-	[[nodiscard]]
-	std::shared_ptr<Node> createComponentNode(const std::shared_ptr<Node>& node, const std::shared_ptr<ComponentBase>& component)
+	AsyncTask<Result> m_task;
+	std::shared_ptr<SharedState> m_state;
+
+	// 中止した読み込み(完了を待たずに破棄するとメインスレッドが待たされるため、完了するまで保持する)
+	Array<AsyncTask<Result>> m_canceledTasks;
+
+	static Result Load(const FilePath& filePath, SharedState& state)
 	{
-		auto componentNode = Node::Create(
-			component->type(),
-			BoxConstraint
-			{
-				.sizeRatio = Vec2{ 1, 0 },
-				.margin = LRTB{ 0, 0, 0, 8 },
-			});
-		componentNode->setLayout(VerticalLayout{ .padding = LRTB{ 0, 0, 0, 8 } });
-		componentNode->emplaceComponent<RectRenderer>(ColorF{ 0.3, 0.3 }, ColorF{ 1.0, 0.3 }, 1.0, 3.0);
+		const Stopwatch stopwatch{ StartImmediately::Yes };
+		Result result{ .filePath = filePath };
 
-		const auto headingNode = componentNode->addChild(CreateHeadingNode(component->type(), ColorF{ 0.3, 0.3, 0.5 }));
-		headingNode->emplaceComponent<ContextMenuOpener>(
-			m_contextMenu,
-			Array<MenuElement>
-			{
-				MenuItem{ U"{} を削除"_fmt(component->type()), U"", [this, node, component] { node->removeComponent(component); refreshInspector(); } },
-				MenuItem{ U"{} を上へ移動"_fmt(component->type()), U"", [this, node, component] { node->moveComponentUp(component); refreshInspector(); } },
-				MenuItem{ U"{} を下へ移動"_fmt(component->type()), U"", [this, node, component] { node->moveComponentDown(component); refreshInspector(); } },
-			});
+		JSON json;
+		try
+		{
+			json = JSON::Load(filePath, AllowExceptions::Yes);
+		}
+		catch (...)
+		{
+			result.status = Status::FailedToLoadFile;
+			return result;
+		}
+		result.loadJSONMillisec = stopwatch.msF();
+		state.progress = 0.5;
 
-		for (const auto& property : component->properties())
+		if (state.canceled)
 		{
-			switch (property->editType())
+			result.status = Status::Canceled;
+			return result;
+		}
+
+		try
+		{
+			// ルートノードは子を除いた部分のみ先に構築し、子は1つずつ構築して進捗の更新と中止の確認を行う
+			JSON rootNodeJSON;
+			for (const auto& member : json)
 			{
-			case PropertyEditType::Text:
-				componentNode->addChild(
-					CreatePropertyNode(
-						property->name(),
-						property->propertyValueString(),
-						[property](StringView value) { property->trySetPropertyValueString(value); }));
-				break;
-			case PropertyEditType::Bool:
-				componentNode->addChild(
-					CreateBoolPropertyNode(
-						property->name(),
-						ParseOr<bool>(property->propertyValueString(), false),
-						[property](bool value) { property->trySetPropertyValueString(Format(value)); }));
-				break;
-			case PropertyEditType::Vec2:
-				componentNode->addChild(
-					CreateVec2PropertyNode(
-						property->name(),
-						ParseOr<Vec2>(property->propertyValueString(), Vec2{ 0, 0 }),
-						[property](const Vec2& value) { property->trySetPropertyValueString(Format(value)); }));
-				break;
-			case PropertyEditType::Color:
-				componentNode->addChild(
-					CreateColorPropertyNode(
-						property->name(),
-						ParseOr<ColorF>(property->propertyValueString(), ColorF{ 0, 0, 0, 1 }),
-						[property](const ColorF& value) { property->trySetPropertyValueString(Format(value)); }));
-				break;
-			case PropertyEditType::LRTB:
-				componentNode->addChild(
-					CreateLRTBPropertyNode(
-						property->name(),
-						ParseOr<LRTB>(property->propertyValueString(), LRTB{ 0, 0, 0, 0 }),
-						[property](const LRTB& value) { property->trySetPropertyValueString(Format(value)); }));
-				break;
-			case PropertyEditType::Enum:
-				componentNode->addChild(
-					CreateEnumPropertyNode(
-						property->name(),
-						property->propertyValueString(),
-						[property](StringView value) { property->trySetPropertyValueString(value); },
-						m_contextMenu,
-						property->enumCandidates()));
-				break;
+				if (member.key != U"children")
+				{
+					rootNodeJSON[member.key] = member.value;
+				}
+			}
+			const auto rootNode = Node::CreateFromJSON(rootNodeJSON);
+
+			if (json.contains(U"children") && json[U"children"].isArray())
+			{
+				const auto childrenJSON = json[U"children"].arrayView();
+				const size_t childCount = childrenJSON.size();
+				size_t builtCount = 0;
+				for (const auto& childJSON : childrenJSON)
+				{
+					if (state.canceled)
+					{
+						result.status = Status::Canceled;
+						return result;
+					}
+					rootNode->addChildFromJSON(childJSON, RefreshesLayoutYN::No);
+					++builtCount;
+					state.progress = 0.5 + 0.5 * static_cast<double>(builtCount) / childCount;
+				}
 			}
+			result.rootNode = rootNode;
+		}
+		catch (...)
+		{
+			result.status = Status::FailedToReadData;
+			return result;
 		}
+		result.buildNodesMillisec = stopwatch.msF() - result.loadJSONMillisec;
+		return result;
+	}
 
-		componentNode->setBoxConstraintToFitToChildren(FitTarget::HeightOnly);
+public:
+	// 読み込みを開始する(読み込み中の場合はそれを中止する)
+	void requestLoad(const FilePath& filePath)
+	{
+		cancel();
+		m_state = std::make_shared<SharedState>();
+		m_task = Async([filePath, state = m_state] { return Load(filePath, *state); });
+	}
 
-		return componentNode;
+	void cancel()
+	{
+		if (!m_task.isValid())
+		{
+			return;
+		}
+		m_state->canceled = true;
+		m_canceledTasks.push_back(std::move(m_task));
 	}
 
-	void clearTargetNode()
+	// 完了した読み込みの結果を返す(毎フレーム呼び出す)
+	[[nodiscard]]
+	Optional<Result> update()
 	{
-		setTargetNode(nullptr);
+		m_canceledTasks.remove_if([](const AsyncTask<Result>& task) { return task.isReady(); });
+
+		if (!m_task.isValid() || !m_task.isReady())
+		{
+			return none;
+		}
+		return m_task.get();
 	}
 
-	void update()
+	[[nodiscard]]
+	bool isBusy() const
 	{
+		return m_task.isValid();
 	}
 
 	[[nodiscard]]
-	const std::shared_ptr<Node>& inspectorFrameNode() const
+	double progress() const
 	{
-		return m_inspectorFrameNode;
+		return m_state ? m_state->progress.load() : 0.0;
 	}
 };
 
@@ -3434,6 +4945,7 @@ private:
 	std::shared_ptr<Canvas> m_editorCanvas;
 	std::shared_ptr<Canvas> m_editorOverlayCanvas;
 	std::shared_ptr<ContextMenu> m_contextMenu;
+	std::shared_ptr<UndoHistory> m_undoHistory;
 	Hierarchy m_hierarchy;
 	Inspector m_inspector;
 	MenuBar m_menuBar;
@@ -3441,8 +4953,95 @@ private:
 	std::weak_ptr<Node> m_prevSelectedNode;
 	bool m_prevSelectedNodeExists = false;
 	Optional<String> m_filePath = none;
+	Optional<String> m_savingFilePath = none; // 完了していない手動保存の保存先(保存の完了前に再度保存した場合に使用)
 	Vec2 m_scrollOffset = Vec2::Zero();
 	double m_scrollScale = 1.0;
+	DocumentSaver m_documentSaver;
+	DocumentLoader m_documentLoader;
+	uint64 m_savedRevision = 0;
+	uint64 m_autosavedRevision = 0;
+	Stopwatch m_autosaveStopwatch{ StartImmediately::Yes };
+	String m_statusText;
+	Stopwatch m_statusTextStopwatch;
+
+	static constexpr Duration AutosaveInterval = Duration{ 60.0 };
+
+	static constexpr Duration StatusTextDuration = Duration{ 3.0 };
+
+	[[nodiscard]]
+	FilePath autosaveFilePath() const
+	{
+		if (m_filePath)
+		{
+			return *m_filePath + U".autosave";
+		}
+		return FileSystem::GetFolderPath(SpecialFolder::LocalAppData) + U"NocoEditor/Untitled.noco.autosave";
+	}
+
+	void setStatusText(StringView text)
+	{
+		m_statusText = text;
+		m_statusTextStopwatch.restart();
+	}
+
+	void requestSave(const FilePath& filePath)
+	{
+		// 編集中のファイルのパスは書き込みに成功した時点で更新する
+		// (保存の完了前に再度保存した場合もダイアログを出さずに同じファイルへ保存するよう、要求中の保存先を控えておく)
+		m_savingFilePath = filePath;
+		m_documentSaver.requestSave(m_canvas->toJSON(), filePath, false, m_undoHistory->documentRevision());
+	}
+
+	// 自動保存を要求した場合はtrueを返す
+	bool autosaveIfNeeded()
+	{
+		const uint64 revision = m_undoHistory->documentRevision();
+		if (revision == m_savedRevision || revision == m_autosavedRevision || m_documentSaver.isBusy())
+		{
+			return false;
+		}
+		m_autosavedRevision = revision;
+		m_documentSaver.requestSave(m_canvas->toJSON(), autosaveFilePath(), true, revision);
+		return true;
+	}
+
+	void onSaveCompleted(const DocumentSaver::Result& result)
+	{
+		if (result.isAutosave)
+		{
+			if (result.succeeded)
+			{
+				setStatusText(U"自動保存しました");
+			}
+			else
+			{
+				Logger << U"[NocoEditor] Autosave to '{}' failed"_fmt(result.filePath);
+			}
+			return;
+		}
+
+		// 新規作成・読み込みで要求中の保存先が破棄されていれば以前のドキュメントの保存のため、パス・保存済みの状態は更新しない
+		const bool isCurrentDocument = m_savingFilePath.has_value();
+		if (!m_documentSaver.hasManualSaveRequest())
+		{
+			m_savingFilePath.reset();
+		}
+
+		if (result.succeeded)
+		{
+			if (isCurrentDocument)
+			{
+				// 保存中に編集された場合は未保存のままとなるよう、保存した内容の状態を記録する
+				m_filePath = result.filePath;
+				m_savedRevision = result.documentRevision;
+			}
+			setStatusText(U"保存しました");
+		}
+		else
+		{
+			System::MessageBoxOK(U"エラー", U"保存に失敗しました", MessageBoxStyle::Error);
+		}
+	}
 
 public:
 	Editor()
@@ -3450,8 +5049,9 @@ public:
 		, m_editorCanvas(Canvas::Create())
 		, m_editorOverlayCanvas(Canvas::Create())
 		, m_contextMenu(std::make_shared<ContextMenu>(m_editorOverlayCanvas, U"EditorContextMenu"))
-		, m_hierarchy(m_canvas, m_editorCanvas, m_contextMenu)
-		, m_inspector(m_canvas, m_editorCanvas, m_contextMenu, [this] { m_hierarchy.refreshNodeNames(); })
+		, m_undoHistory(std::make_shared<UndoHistory>())
+		, m_hierarchy(m_canvas, m_editorCanvas, m_contextMenu, m_undoHistory)
+		, m_inspector(m_canvas, m_editorCanvas, m_contextMenu, m_undoHistory, [this] { m_hierarchy.refreshNodeNames(); })
 		, m_menuBar(m_editorCanvas, m_contextMenu)
 		, m_prevSceneSize(Scene::Size())
 	{
@@ -3472,6 +5072,9 @@ public:
 			U"Edit",
 			U"編集",
 			{
+				MenuItem{ U"元に戻す", U"Ctrl+Z", [this] { onClickMenuEditUndo(); }, [this] { return m_undoHistory->canUndo(); } },
+				MenuItem{ U"やり直し", U"Ctrl+Y", [this] { onClickMenuEditRedo(); }, [this] { return m_undoHistory->canRedo(); } },
+				MenuSeparator{},
 				MenuItem{ U"切り取り", U"Ctrl+X", [this] { onClickMenuEditCut(); }, [this] { return m_hierarchy.hasSelection(); } },
 				MenuItem{ U"コピー", U"Ctrl+C", [this] { onClickMenuEditCopy(); }, [this] { return m_hierarchy.hasSelection(); } },
 				MenuItem{ U"貼り付け", U"Ctrl+V", [this] { onClickMenuEditPaste(); }, [this] { return m_hierarchy.canPaste(); } },
@@ -3531,6 +5134,30 @@ public:
 			m_prevSceneSize = sceneSize;
 		}
 
+		// ワーカースレッドでの読み込みの完了を確認
+		if (m_documentLoader.isBusy() && KeyEscape.down())
+		{
+			m_documentLoader.cancel();
+			setStatusText(U"読み込みを中止しました");
+		}
+		if (const auto loadResult = m_documentLoader.update())
+		{
+			onLoadCompleted(*loadResult);
+		}
+
+		// ワーカースレッドでの保存の完了を確認
+		if (const auto saveResult = m_documentSaver.update())
+		{
+			onSaveCompleted(*saveResult);
+		}
+
+		// 前回の保存以降に変更があれば一定間隔で自動保存
+		// (変更がない場合や保存中で要求しなかった場合は計測を続け、要求した時点から計測し直す)
+		if (m_autosaveStopwatch.elapsed() >= AutosaveInterval && autosaveIfNeeded())
+		{
+			m_autosaveStopwatch.restart();
+		}
+
 		// ショートカットキー
 		const bool isWindowActive = Window::GetState().focused;
 		if (isWindowActive)
@@ -3569,6 +5196,20 @@ public:
 				}
 			}
 
+			// 元に戻す・やり直し
+			// (テキストボックス編集中はテキストボックス側の操作を優先する)
+			if (context.editingTextBox.expired())
+			{
+				if (ctrl && !alt && !shift && KeyZ.down())
+				{
+					onClickMenuEditUndo();
+				}
+				else if ((ctrl && !alt && !shift && KeyY.down()) || (ctrl && !alt && shift && KeyZ.down()))
+				{
+					onClickMenuEditRedo();
+				}
+			}
+
 			// Hierarchy操作
 			// (テキストボックス編集中は実行しない)
 			if (context.editingTextBox.expired())
@@ -3630,6 +5271,25 @@ public:
 		m_hierarchy.drawSelectedNodesGizmo();
 		m_editorCanvas->draw();
 		m_editorOverlayCanvas->draw();
+
+		// 読み込み・保存の進捗と結果
+		String statusText;
+		if (m_documentLoader.isBusy())
+		{
+			statusText = U"読み込み中... {:.0f}% (Escキーで中止)"_fmt(m_documentLoader.progress() * 100);
+		}
+		else if (m_documentSaver.isBusy())
+		{
+			statusText = U"{}中... {:.0f}%"_fmt(m_documentSaver.isAutosaving() ? U"自動保存" : U"保存", m_documentSaver.progress() * 100);
+		}
+		else if (m_statusTextStopwatch.isStarted() && m_statusTextStopwatch.elapsed() < StatusTextDuration)
+		{
+			statusText = m_statusText;
+		}
+		if (!statusText.empty())
+		{
+			FontAsset(U"Font14")(statusText).draw(Arg::bottomLeft = Vec2{ 310, Scene::Height() - 6 }, ColorF{ 1.0 });
+		}
 	}
 
 	const std::shared_ptr<Canvas>& canvas() const
@@ -3663,7 +5323,10 @@ public:
 	void onClickMenuFileNew()
 	{
 		m_filePath = none;
+		m_savingFilePath.reset();
 		m_canvas->removeChildrenAll();
+		m_undoHistory->clear();
+		m_savedRevision = m_autosavedRevision = m_undoHistory->documentRevision();
 		refresh();
 	}
 
@@ -3671,29 +5334,46 @@ public:
 	{
 		if (const auto filePath = Dialog::OpenFile({ FileFilter{ U"NocoUI Canvas", { U"noco" } }, FileFilter::AllFiles() }))
 		{
-			JSON json;
-			try
-			{
-				json = JSON::Load(*filePath, AllowExceptions::Yes);
-			}
-			catch (...)
-			{
-				System::MessageBoxOK(U"エラー", U"ファイルの読み込みに失敗しました", MessageBoxStyle::Error);
-				return;
-			}
-			m_filePath = filePath;
-			if (!m_canvas->tryReadFromJSON(json))
-			{
-				System::MessageBoxOK(U"エラー", U"データの読み取りに失敗しました", MessageBoxStyle::Error);
-				return;
-			}
-			refresh();
+			m_documentLoader.requestLoad(*filePath);
+		}
+	}
+
+	void onLoadCompleted(const DocumentLoader::Result& result)
+	{
+		switch (result.status)
+		{
+		case DocumentLoader::Status::Succeeded:
+			break;
+		case DocumentLoader::Status::FailedToLoadFile:
+			System::MessageBoxOK(U"エラー", U"ファイルの読み込みに失敗しました", MessageBoxStyle::Error);
+			return;
+		case DocumentLoader::Status::FailedToReadData:
+			System::MessageBoxOK(U"エラー", U"データの読み取りに失敗しました", MessageBoxStyle::Error);
+			return;
+		case DocumentLoader::Status::Canceled:
+			return;
 		}
+
+		// 大きなファイルでの読み込み時間を確認できるよう、各段階の所要時間をログに出力する
+		const Stopwatch stopwatch{ StartImmediately::Yes };
+		m_filePath = result.filePath;
+		m_savingFilePath.reset();
+		m_undoHistory->clear();
+		m_savedRevision = m_autosavedRevision = m_undoHistory->documentRevision();
+		m_canvas->setRootNode(result.rootNode);
+		refresh();
+		const double attachMillisec = stopwatch.msF();
+		Logger << U"[NocoEditor] Opened '{}' ({} nodes): JSON {:.1f}ms, Nodes {:.1f}ms (worker), Attach+Hierarchy {:.1f}ms (main)"_fmt(
+			result.filePath,
+			m_hierarchy.elementCount(),
+			result.loadJSONMillisec,
+			result.buildNodesMillisec,
+			attachMillisec);
 	}
 
 	void onClickMenuFileSave()
 	{
-		Optional<String> filePath = m_filePath;
+		Optional<String> filePath = m_savingFilePath ? m_savingFilePath : m_filePath;
 		if (filePath == none)
 		{
 			filePath = Dialog::SaveFile({ FileFilter{ U"NocoUI Canvas", { U"noco" } }, FileFilter::AllFiles() });
@@ -3702,28 +5382,14 @@ public:
 				return;
 			}
 		}
-		if (m_canvas->toJSON().save(*filePath))
-		{
-			m_filePath = filePath;
-		}
-		else
-		{
-			System::MessageBoxOK(U"エラー", U"保存に失敗しました", MessageBoxStyle::Error);
-		}
+		requestSave(*filePath);
 	}
 
 	void onClickMenuFileSaveAs()
 	{
 		if (const auto filePath = Dialog::SaveFile({ FileFilter{ U"NocoUI Canvas", { U"noco" } }, FileFilter::AllFiles() }))
 		{
-			if (m_canvas->toJSON().save(*filePath))
-			{
-				m_filePath = filePath;
-			}
-			else
-			{
-				System::MessageBoxOK(U"エラー", U"保存に失敗しました", MessageBoxStyle::Error);
-			}
+			requestSave(*filePath);
 		}
 	}
 
@@ -3732,6 +5398,32 @@ public:
 		System::Exit();
 	}
 
+	void onClickMenuEditUndo()
+	{
+		if (m_undoHistory->undo())
+		{
+			onUndoRedo();
+		}
+	}
+
+	void onClickMenuEditRedo()
+	{
+		if (m_undoHistory->redo())
+		{
+			onUndoRedo();
+		}
+	}
+
+	void onUndoRedo()
+	{
+		// 履歴の適用ではレイアウト更新を省略しているため、ここでまとめて行う
+		m_canvas->refreshLayout();
+		m_hierarchy.refreshNodeList();
+
+		// 表示中の値が変わっている可能性があるため、インスペクタは作り直す
+		m_inspector.rebuildInspector();
+	}
+
 	void onClickMenuEditCut()
 	{
 		m_hierarchy.onClickCut();
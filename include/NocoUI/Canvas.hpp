@@ -1,6 +1,11 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
 #include "Node.hpp"
+#include "CanvasStats.hpp"
+#include "Trace.hpp"
+#include "LayoutInvalidation.hpp"
+#include "detail/ChangeTracking.hpp"
+#include "detail/ScopedScissorRect.hpp"
 
 namespace noco
 {
@@ -33,13 +38,311 @@ namespace noco
 		Vec2 m_offset = Vec2::Zero();
 		Vec2 m_scale = Vec2::One();
 
-		Mat3x2 rootEffectMat() const
+		Array<NodeEvent> m_pendingEvents;
+
+		bool m_retainedModeEnabled = false;
+		bool m_partialRedrawEnabled = false;
+		bool m_refreshRequested = true;
+		detail::CanvasActivity m_activity;
+		detail::ChangeCounter m_changeCounter; // このCanvasに属するノードの変更回数
+		bool m_lastUpdateSkipped = false;
+		uint64 m_updatedChangeCount = 0;
+		uint64 m_updatedStructureChangeCount = 0;
+		bool m_prevCanHover = false;
+		Size m_prevSceneSize = Size::Zero();
+		std::weak_ptr<Node> m_prevHoveredNode;
+		std::weak_ptr<Node> m_prevScrollableHoveredNode;
+		mutable RenderTexture m_retainedTexture;
+		mutable bool m_retainedTextureDirty = true;
+		mutable detail::DirtyRegion m_dirtyRegion;
+		mutable uint64 m_drawnChangeCount = 0;
+
+		bool m_batchedSmoothingEnabled = false;
+		detail::SmoothingBatch m_smoothingBatch;
+
+		LayoutScratch m_layoutScratch;
+		size_t m_parallelLayoutThreshold = 0;
+		mutable detail::ClipStack m_clipStack;
+		Optional<RectF> m_layoutArea = none;
+
+		bool m_statsEnabled = false;
+		mutable CanvasStats m_stats;
+		mutable CanvasStats m_lastFrameStats;
+		mutable int32 m_statsFrameCount = -1;
+
+		// 統計情報の記録先を返す(無効の場合はnullptr)
+		// (フレームが変わっていれば直前のフレームの統計情報を退避してから新しく記録を始める)
+		[[nodiscard]]
+		CanvasStats* statsForCurrentFrame() const
 		{
-			if (m_scale == Vec2::One() && m_offset == Vec2::Zero())
+			if (!m_statsEnabled)
 			{
-				return Mat3x2::Identity();
+				return nullptr;
 			}
-			return Mat3x2::Scale(m_scale) * Mat3x2::Translate(m_offset);
+			const int32 frameCount = Scene::FrameCount();
+			if (frameCount != m_statsFrameCount)
+			{
+				if (m_statsFrameCount >= 0)
+				{
+					m_lastFrameStats = m_stats;
+				}
+				m_stats = CanvasStats{};
+				m_statsFrameCount = frameCount;
+			}
+			return &m_stats;
+		}
+
+		bool m_layoutInvalidationTracingEnabled = false;
+		CapturesStackTraceYN m_capturesLayoutInvalidationStackTrace = CapturesStackTraceYN::No;
+		Array<LayoutInvalidationRecord> m_layoutInvalidations;
+		Array<LayoutInvalidationRecord> m_lastFrameLayoutInvalidations;
+		int32 m_layoutInvalidationFrameCount = -1;
+
+		void rolloverLayoutInvalidationsIfNeeded()
+		{
+			const int32 frameCount = Scene::FrameCount();
+			if (frameCount != m_layoutInvalidationFrameCount)
+			{
+				m_lastFrameLayoutInvalidations = std::exchange(m_layoutInvalidations, {});
+				m_layoutInvalidationFrameCount = frameCount;
+			}
+		}
+
+		void recordLayoutInvalidation(StringView nodeName, const std::source_location& location)
+		{
+			if (!m_layoutInvalidationTracingEnabled)
+			{
+				return;
+			}
+			rolloverLayoutInvalidationsIfNeeded();
+			m_layoutInvalidations.push_back(LayoutInvalidationRecord::Create(nodeName, location, m_capturesLayoutInvalidationStackTrace));
+		}
+
+		void refreshLayoutImpl()
+		{
+			CanvasStats* pStats = statsForCurrentFrame();
+			const detail::ScopedCanvasStats scopedStats{ pStats, &CanvasStats::layoutTime };
+			if (pStats)
+			{
+				++pStats->layoutPassCount;
+			}
+			NOCO_TRACE_ZONE(U"Canvas::refreshLayout");
+
+			const RectF area = layoutArea();
+			const auto& rootConstraint = m_rootNode->constraint();
+			if (const auto pBoxConstraint = std::get_if<BoxConstraint>(&rootConstraint))
+			{
+				m_rootNode->m_layoutAppliedRect = pBoxConstraint->applyConstraint(area, Vec2::Zero());
+			}
+			else if (const auto pAnchorConstraint = std::get_if<AnchorConstraint>(&rootConstraint))
+			{
+				m_rootNode->m_layoutAppliedRect = pAnchorConstraint->applyConstraint(area, Vec2::Zero());
+			}
+			else
+			{
+				// TODO: 実行時例外ではなくコンパイルエラーにしたい
+				throw Error{ U"Unknown root node constraint" };
+			}
+
+			m_rootNode->refreshChildrenLayout(m_layoutScratch, m_parallelLayoutThreshold);
+			m_rootNode->refreshEffectedRect(Mat3x2::Identity(), Vec2::One());
+		}
+
+		void dispatchPendingEvents()
+		{
+			if (m_pendingEvents.empty())
+			{
+				return;
+			}
+			NOCO_TRACE_ZONE(U"DispatchEvents");
+
+			// ハンドラ内で発生したイベントは次回の更新で通知する
+			const Array<NodeEvent> events = std::exchange(m_pendingEvents, {});
+			if (CanvasStats* pStats = detail::CurrentCanvasStats())
+			{
+				pStats->dispatchedEventCount += events.size();
+			}
+			for (const auto& event : events)
+			{
+				event.node->invokeEventHandlers(event.type);
+			}
+		}
+
+		[[nodiscard]]
+		static bool HasPointerInput()
+		{
+			return !Cursor::DeltaF().isZero()
+				|| MouseL.pressed() || MouseL.up()
+				|| MouseR.pressed() || MouseR.up()
+				|| Mouse::Wheel() != 0.0 || Mouse::WheelH() != 0.0;
+		}
+
+		// リテインドモードで今回の更新を省略できるかどうか
+		// (前回の更新以降に入力・変更がなく、前回の更新でアニメーション中のノードもなかった場合に省略できる)
+		[[nodiscard]]
+		bool canSkipUpdate(bool canHover) const
+		{
+			return !m_refreshRequested
+				&& !m_activity.requiresUpdate
+				&& m_pendingEvents.empty()
+				&& m_updatedChangeCount == m_changeCounter.changeCount()
+				&& m_prevCanHover == canHover
+				&& m_prevSceneSize == Scene::Size()
+				&& !HasPointerInput();
+		}
+
+		static void ReportHoveredNodes(CanvasUpdateContext* pContext, const std::shared_ptr<Node>& hoveredNode, const std::shared_ptr<Node>& scrollableHoveredNode)
+		{
+			if (!pContext)
+			{
+				return;
+			}
+			pContext->canHover = pContext->canHover && hoveredNode == nullptr;
+			if (hoveredNode)
+			{
+				pContext->hoveredNode = hoveredNode;
+			}
+			if (scrollableHoveredNode)
+			{
+				pContext->scrollableHoveredNode = scrollableHoveredNode;
+			}
+		}
+
+		// キャッシュ用のテクスチャへは乗算済みアルファで書き込み、BlendState::Premultipliedで合成する
+		// (通常のブレンドのまま透明なテクスチャへ書き込むと、半透明部分のアルファ値が正しく合成されないため)
+		[[nodiscard]]
+		static BlendState RetainedTextureBlendState()
+		{
+			BlendState blendState = BlendState::Default2D;
+			blendState.srcAlpha = Blend::One;
+			blendState.dstAlpha = Blend::InvSrcAlpha;
+			return blendState;
+		}
+
+		// 既存の内容を指定した色で置き換えるブレンド(部分再描画の範囲を透明に戻すためのもの)
+		[[nodiscard]]
+		static BlendState OverwriteBlendState()
+		{
+			BlendState blendState = BlendState::Default2D;
+			blendState.src = Blend::One;
+			blendState.dst = Blend::Zero;
+			blendState.srcAlpha = Blend::One;
+			blendState.dstAlpha = Blend::Zero;
+			return blendState;
+		}
+
+		// dirtyRectsが空の場合は全体を描画し、そうでない場合は各矩形の範囲内のみを描画し直す
+		void drawNodes(CanvasStats* pStats, const Array<RectF>& dirtyRects = {}) const
+		{
+			const Optional<Transformer2D> transformer = createViewTransformer();
+			m_clipStack.setTransform(detail::ClipStack::CurrentGraphicsTransform());
+			m_clipStack.resetScissorChangeCount();
+			if (dirtyRects.empty())
+			{
+				m_rootNode->draw(m_clipStack);
+			}
+			else
+			{
+				m_clipStack.setCullsOutside(true);
+				for (const auto& dirtyRect : dirtyRects)
+				{
+					// 範囲内を透明に戻してから、範囲と重なるノードを描画順通りに描画し直す
+					const detail::ScopedScissorRect scissorRect{ m_clipStack, dirtyRect.asRect() };
+					{
+						const ScopedRenderStates2D blendState{ OverwriteBlendState() };
+						dirtyRect.stretched(1.0).draw(ColorF{ 0.0, 0.0 });
+					}
+					m_rootNode->draw(m_clipStack);
+				}
+				m_clipStack.setCullsOutside(false);
+				if (pStats)
+				{
+					pStats->partialRedrawRectCount += dirtyRects.size();
+				}
+			}
+
+			if (pStats)
+			{
+				pStats->scissorChangeCount += m_clipStack.scissorChangeCount();
+			}
+		}
+
+		// 保持用のテクスチャへは外側のTransformer2D・カメラの変換を適用せずに描画する
+		// (変換はテクスチャを描画する際に一度だけ適用するため。変換が変わってもテクスチャを描画し直す必要がない)
+		[[nodiscard]]
+		static std::pair<Transformer2D, Transformer2D> CreateRetainedTextureTransformers()
+		{
+			return { std::piecewise_construct,
+				std::forward_as_tuple(Mat3x2::Identity(), Transformer2D::Target::SetLocal),
+				std::forward_as_tuple(Mat3x2::Identity(), Transformer2D::Target::SetCamera) };
+		}
+
+		void drawRetained(CanvasStats* pStats) const
+		{
+			// 描画先(RenderTexture上に描画する場合を含む)と同じサイズで保持する
+			const Size renderTargetSize = Graphics2D::GetRenderTargetSize();
+			if (m_retainedTexture.isEmpty() || m_retainedTexture.size() != renderTargetSize)
+			{
+				m_retainedTexture = RenderTexture{ renderTargetSize };
+				m_retainedTextureDirty = true;
+			}
+
+			// update()以降に変更された場合は、変更箇所を特定できないため全体を描画し直す
+			const uint64 changeCount = m_changeCounter.changeCount();
+			const bool changedAfterUpdate = changeCount != m_updatedChangeCount && changeCount != m_drawnChangeCount;
+			if (m_retainedTextureDirty || changedAfterUpdate || m_dirtyRegion.isAll())
+			{
+				m_retainedTexture.clear(ColorF{ 0.0, 0.0 });
+				{
+					const ScopedRenderTarget2D renderTarget{ m_retainedTexture };
+					const ScopedRenderStates2D blendState{ RetainedTextureBlendState() };
+					const auto transformers = CreateRetainedTextureTransformers();
+					drawNodes(pStats);
+				}
+				m_retainedTextureDirty = false;
+			}
+			else if (!m_dirtyRegion.isEmpty())
+			{
+				const ScopedRenderTarget2D renderTarget{ m_retainedTexture };
+				const ScopedRenderStates2D blendState{ RetainedTextureBlendState() };
+				const auto transformers = CreateRetainedTextureTransformers();
+				drawNodes(pStats, m_dirtyRegion.rects());
+			}
+			else if (pStats)
+			{
+				++pStats->cachedDrawCount;
+			}
+			m_dirtyRegion.clear();
+			m_drawnChangeCount = changeCount;
+
+			const ScopedRenderStates2D blendState{ BlendState::Premultiplied };
+			m_retainedTexture.draw();
+		}
+
+		// ビュー変換(オフセット・拡大率)を描画時のTransformer2Dで適用する
+		// (ノードの矩形はビュー変換前の座標系で保持するため、オフセット・拡大率の変更でノードツリーの再計算は不要)
+		// (拡大率はノードのeffectScaleに含めないため、Label・TextBoxの文字はフォントのラスタライズ時のサイズのまま拡大縮小して描画される。
+		//  拡大時にビットマップフォントの輪郭がぼやける代わりに、拡大率の変更ごとにレイアウトや文字の配置のキャッシュを作り直さずに済む。
+		//  拡大して表示する場合はSDF・MSDFのフォントを使用すること)
+		[[nodiscard]]
+		Optional<Transformer2D> createViewTransformer() const
+		{
+			if (!hasViewTransform())
+			{
+				return none;
+			}
+			return Optional<Transformer2D>{ std::in_place, viewTransform() };
+		}
+
+		// ヒットテスト用にマウスカーソル座標のみをビュー変換の逆変換で変換する
+		[[nodiscard]]
+		Optional<Transformer2D> createViewCursorTransformer() const
+		{
+			if (!hasViewTransform())
+			{
+				return none;
+			}
+			return Optional<Transformer2D>{ std::in_place, Mat3x2::Identity(), viewTransform() };
 		}
 
 		explicit Canvas()
@@ -64,6 +367,15 @@ namespace noco
 		}
 
 	public:
+		~Canvas()
+		{
+			// 破棄後のCanvasの変更回数をノードが参照しないよう、ノードをCanvasから外す
+			if (m_rootNode)
+			{
+				m_rootNode->setCanvasRecursive(std::weak_ptr<Canvas>{});
+			}
+		}
+
 		[[nodiscard]]
 		static std::shared_ptr<Canvas> Create()
 		{
@@ -91,25 +403,10 @@ namespace noco
 			return canvas;
 		}
 
-		void refreshLayout()
+		void refreshLayout(const std::source_location& location = std::source_location::current())
 		{
-			const auto& rootConstraint = m_rootNode->constraint();
-			if (const auto pBoxConstraint = std::get_if<BoxConstraint>(&rootConstraint))
-			{
-				m_rootNode->m_layoutAppliedRect = pBoxConstraint->applyConstraint(Scene::Rect(), Vec2::Zero());
-			}
-			else if (const auto pAnchorConstraint = std::get_if<AnchorConstraint>(&rootConstraint))
-			{
-				m_rootNode->m_layoutAppliedRect = pAnchorConstraint->applyConstraint(Scene::Rect(), Vec2::Zero());
-			}
-			else
-			{
-				// TODO: 実行時例外ではなくコンパイルエラーにしたい
-				throw Error{ U"Unknown root node constraint" };
-			}
-
-			m_rootNode->refreshChildrenLayout();
-			m_rootNode->refreshEffectedRect(rootEffectMat(), m_scale);
+			recordLayoutInvalidation(U"", location);
+			refreshLayoutImpl();
 		}
 
 		bool containsNodeByName(const String& nodeName) const
@@ -137,27 +434,94 @@ namespace noco
 
 		bool tryReadFromJSON(const JSON& json, RefreshesLayoutYN refreshesLayout = RefreshesLayoutYN::Yes)
 		{
-			m_rootNode = Node::CreateFromJSON(json);
+			setRootNode(Node::CreateFromJSON(json), refreshesLayout);
+			return true; // TODO: 失敗したらfalseを返す
+		}
+
+		// 構築済みのノードツリーをルートノードとして設定する
+		// (別スレッドでCanvasに属さないツリーを構築しておき、メインスレッドではこれを呼ぶだけで済むようにする)
+		void setRootNode(const std::shared_ptr<Node>& rootNode, RefreshesLayoutYN refreshesLayout = RefreshesLayoutYN::Yes)
+		{
+			if (!rootNode)
+			{
+				throw Error{ U"setRootNode: rootNode is nullptr" };
+			}
+			if (rootNode->parent())
+			{
+				throw Error{ U"setRootNode: Node '{}' already has a parent"_fmt(rootNode->name()) };
+			}
+			if (m_rootNode && m_rootNode != rootNode)
+			{
+				m_rootNode->setCanvasRecursive(std::weak_ptr<Canvas>{});
+			}
+			m_rootNode = rootNode;
 			m_rootNode->setCanvasRecursive(shared_from_this());
+			requestRefresh();
 			if (refreshesLayout)
 			{
 				refreshLayout();
 			}
-			return true; // TODO: 失敗したらfalseを返す
 		}
 
 		void update(CanvasUpdateContext* pContext = nullptr)
 		{
-			// ホバー中ノード取得
+			const detail::ScopedCanvasStats scopedStats{ statsForCurrentFrame(), &CanvasStats::updateTime };
+			if (m_layoutInvalidationTracingEnabled)
+			{
+				// レイアウト更新要求のないフレームでも直前のフレームの記録を正しく切り替えるため
+				rolloverLayoutInvalidationsIfNeeded();
+			}
+
+			NOCO_TRACE_ZONE(U"Canvas::update");
+
 			const bool canHover = (pContext ? pContext->canHover && !pContext->isHovered() : true) && Window::GetState().focused; // TODO: 本来はウィンドウがアクティブでない場合もホバーさせたい
-			const auto hoveredNode = canHover ? m_rootNode->hoveredNodeInChildren() : nullptr;
+			if (m_retainedModeEnabled && canSkipUpdate(canHover))
+			{
+				// 更新を省略する場合も、重なった他のCanvasのために前回のホバー中ノードは通知する
+				if (CanvasStats* pStats = detail::CurrentCanvasStats())
+				{
+					++pStats->skippedUpdateCount;
+				}
+				m_lastUpdateSkipped = true;
+				ReportHoveredNodes(pContext, m_prevHoveredNode.lock(), m_prevScrollableHoveredNode.lock());
+				return;
+			}
 
-			// スクロール可能なホバー中ノード取得
-			auto scrollableHoveredNode = hoveredNode ? hoveredNode->findContainedScrollableNode() : nullptr;
-			if (scrollableHoveredNode && !scrollableHoveredNode->rect().mouseOver())
+			m_lastUpdateSkipped = false;
+			m_refreshRequested = false;
+			m_activity.requiresUpdate = HasPointerInput(); // 入力があったフレームの次のフレームも、入力による状態の変化を反映するため更新する
+			m_prevCanHover = canHover;
+			m_prevSceneSize = Scene::Size();
+
+			// 部分再描画では、ノードの削除・並べ替えなどノード単位で範囲を特定できない変更があった場合のみ全体を描画し直す
+			const uint64 structureChangeCount = m_changeCounter.structureChangeCount();
+			const bool tracksDirtyRegion = m_retainedModeEnabled && m_partialRedrawEnabled;
+			if (!tracksDirtyRegion || structureChangeCount != m_updatedStructureChangeCount)
 			{
-				// 子がホバー中でもスクロール可能ノード自身にマウスカーソルが重なっていない場合はスクロールしない
-				scrollableHoveredNode = nullptr;
+				m_retainedTextureDirty = true;
+			}
+			m_updatedStructureChangeCount = structureChangeCount;
+			m_activity.pDirtyRegion = tracksDirtyRegion ? &m_dirtyRegion : nullptr;
+			const detail::ScopedCanvasActivity scopedActivity{ m_retainedModeEnabled ? &m_activity : nullptr };
+
+			// 以降のヒットテストはビュー変換前の座標系で行う
+			const Optional<Transformer2D> cursorTransformer = createViewCursorTransformer();
+
+			std::shared_ptr<Node> hoveredNode;
+			std::shared_ptr<Node> scrollableHoveredNode;
+			{
+				NOCO_TRACE_ZONE(U"HoverResolution");
+
+				// ホバー中ノード取得
+				hoveredNode = canHover ? m_rootNode->hoveredNodeInChildren() : nullptr;
+
+				// スクロール可能なホバー中ノード取得
+				scrollableHoveredNode = hoveredNode ? hoveredNode->findContainedScrollableNode() : nullptr;
+				if (scrollableHoveredNode && !scrollableHoveredNode->hitTest(Cursor::PosF()))
+				{
+					// 子がホバー中でもスクロール可能ノード自身にマウスカーソルが重なっていない場合はスクロールしない
+					scrollableHoveredNode = nullptr;
+				}
 			}
 
 			// スクロール実行
@@ -172,25 +536,129 @@ namespace noco
 			}
 
 			// ノード更新
-			m_rootNode->update(pContext, hoveredNode, scrollableHoveredNode, Scene::DeltaTime(), rootEffectMat(), m_scale, InteractableYN::Yes, InteractState::Default, InteractState::Default);
-
-			if (pContext)
+			// (ここまでの変更はノードの更新中に検出されるため、ここでの変更回数を記録する)
+			m_updatedChangeCount = m_changeCounter.changeCount();
 			{
-				pContext->canHover = pContext->canHover && hoveredNode == nullptr;
-				if (hoveredNode)
-				{
-					pContext->hoveredNode = hoveredNode;
-				}
-				if (scrollableHoveredNode)
+				const detail::ScopedSmoothingBatch scopedSmoothingBatch{ m_batchedSmoothingEnabled ? &m_smoothingBatch : nullptr };
+				m_rootNode->update(pContext, hoveredNode, scrollableHoveredNode, Scene::DeltaTime(), Mat3x2::Identity(), Vec2::One(), InteractableYN::Yes, InteractState::Default, InteractState::Default);
+			}
+			if (!m_smoothingBatch.isEmpty())
+			{
+				NOCO_TRACE_ZONE(U"BatchedSmoothing");
+				m_smoothingBatch.execute(Scene::DeltaTime());
+
+				// 書き戻した値による描画範囲の変化はノードの更新時点では分からないため、全体を描画し直す
+				if (tracksDirtyRegion)
 				{
-					pContext->scrollableHoveredNode = scrollableHoveredNode;
+					m_dirtyRegion.markAll();
 				}
 			}
+
+			// ノードの更新中に発生したイベントを通知
+			// (ハンドラ内でのノードの追加・削除がノードの更新中に起きないよう、更新後にまとめて呼び出す)
+			dispatchPendingEvents();
+
+			m_prevHoveredNode = hoveredNode;
+			m_prevScrollableHoveredNode = scrollableHoveredNode;
+			ReportHoveredNodes(pContext, hoveredNode, scrollableHoveredNode);
 		}
 
 		void draw() const
 		{
-			m_rootNode->draw();
+			CanvasStats* pStats = statsForCurrentFrame();
+			const detail::ScopedCanvasStats scopedStats{ pStats, &CanvasStats::drawTime };
+			NOCO_TRACE_ZONE(U"Canvas::draw");
+
+			if (m_retainedModeEnabled)
+			{
+				drawRetained(pStats);
+			}
+			else
+			{
+				drawNodes(pStats);
+			}
+		}
+
+		// リテインドモード: 入力・変更・アニメーション中のノードがないフレームではノードツリーの更新を省略し、前回の描画結果をテクスチャから描画する
+		// (プロパティの変更やノードの操作は自動で検出する。それ以外の要因で表示を変える場合はrequestRefresh()を呼ぶ)
+		void setRetainedModeEnabled(bool enabled)
+		{
+			m_retainedModeEnabled = enabled;
+			if (!enabled)
+			{
+				m_retainedTexture = RenderTexture{};
+				m_dirtyRegion.clear();
+			}
+			requestRefresh();
+		}
+
+		[[nodiscard]]
+		bool retainedModeEnabled() const
+		{
+			return m_retainedModeEnabled;
+		}
+
+		// リテインドモードで、前回の描画結果のうち変化したノードの範囲のみを描画し直す
+		// (コンポーネントが描画する範囲はComponentBase::drawBoundsで求める。範囲を特定できない変化があった場合は全体を描画し直す)
+		void setPartialRedrawEnabled(bool enabled)
+		{
+			m_partialRedrawEnabled = enabled;
+			requestRefresh();
+		}
+
+		[[nodiscard]]
+		bool partialRedrawEnabled() const
+		{
+			return m_partialRedrawEnabled;
+		}
+
+		// コンポーネントのプロパティのSmoothDampを、ノードごとではなくupdate()の最後にまとめて計算する
+		// (多数のプロパティが同時にアニメーションする場合向け。有効な場合、ノードの更新中にコンポーネントから参照される値は前回のupdate()の時点のものになる)
+		void setBatchedSmoothingEnabled(bool enabled)
+		{
+			m_batchedSmoothingEnabled = enabled;
+		}
+
+		[[nodiscard]]
+		bool batchedSmoothingEnabled() const
+		{
+			return m_batchedSmoothingEnabled;
+		}
+
+		// このCanvasに属するノード・コンポーネント・プロパティの変更回数
+		// (前回取得した値と比較することで、ノードツリーを走査せずに変更の有無を判定できる)
+		[[nodiscard]]
+		uint64 changeCount() const
+		{
+			return m_changeCounter.changeCount();
+		}
+
+		// 次回のupdate()・draw()でノードツリーの更新と再描画を強制する
+		void requestRefresh()
+		{
+			m_refreshRequested = true;
+			m_retainedTextureDirty = true;
+		}
+
+		// 直近のupdate()がリテインドモードにより省略されたかどうか
+		[[nodiscard]]
+		bool isIdle() const
+		{
+			return m_lastUpdateSkipped;
+		}
+
+		// 描画中のクリッピング範囲のスタック(コンポーネントから現在の範囲を参照・追加するためのもの)
+		[[nodiscard]]
+		detail::ClipStack& clipStack() const
+		{
+			return m_clipStack;
+		}
+
+		// 直近のdraw()でScissorRectを変更した回数
+		[[nodiscard]]
+		size_t scissorChangeCount() const
+		{
+			return m_clipStack.scissorChangeCount();
 		}
 
 		[[nodiscard]]
@@ -207,7 +675,7 @@ namespace noco
 		void setOffset(const Vec2& offset)
 		{
 			m_offset = offset;
-			m_rootNode->refreshEffectedRect(rootEffectMat(), m_scale);
+			requestRefresh();
 		}
 
 		[[nodiscard]]
@@ -219,7 +687,7 @@ namespace noco
 		void setScale(const Vec2& scale)
 		{
 			m_scale = scale;
-			m_rootNode->refreshEffectedRect(rootEffectMat(), m_scale);
+			requestRefresh();
 		}
 
 		[[nodiscard]]
@@ -228,11 +696,160 @@ namespace noco
 			return m_scale;
 		}
 
+		[[nodiscard]]
+		bool hasViewTransform() const
+		{
+			return m_scale != Vec2::One() || m_offset != Vec2::Zero();
+		}
+
+		// ビュー変換前の座標系から画面上の座標系への変換
+		[[nodiscard]]
+		Mat3x2 viewTransform() const
+		{
+			return Mat3x2::Scale(m_scale) * Mat3x2::Translate(m_offset);
+		}
+
+		[[nodiscard]]
+		RectF viewTransformedRect(const RectF& rect) const
+		{
+			if (!hasViewTransform())
+			{
+				return rect;
+			}
+			return RectF{ rect.pos * m_scale + m_offset, rect.size * m_scale };
+		}
+
+		[[nodiscard]]
+		Quad viewTransformedQuad(const Quad& quad) const
+		{
+			if (!hasViewTransform())
+			{
+				return quad;
+			}
+			const Mat3x2 mat = viewTransform();
+			return Quad{ mat.transformPoint(quad.p0), mat.transformPoint(quad.p1), mat.transformPoint(quad.p2), mat.transformPoint(quad.p3) };
+		}
+
+		// ルートノードのレイアウト基準とする領域を設定する(noneの場合はシーンの矩形を使用)
+		// (ウィンドウサイズに依存せずに同じ条件でレイアウトを計測・再現したい場合に使用)
+		void setLayoutArea(const Optional<RectF>& area, RefreshesLayoutYN refreshesLayout = RefreshesLayoutYN::Yes)
+		{
+			m_layoutArea = area;
+			m_rootNode->markLayoutAsDirty();
+			if (refreshesLayout)
+			{
+				refreshLayout();
+			}
+		}
+
+		[[nodiscard]]
+		RectF layoutArea() const
+		{
+			return m_layoutArea.value_or(RectF{ Scene::Rect() });
+		}
+
+		// フレームごとの統計情報の記録を有効にする(無効の場合は記録処理をほぼ行わない)
+		void setStatsEnabled(bool enabled)
+		{
+			m_statsEnabled = enabled;
+		}
+
+		[[nodiscard]]
+		bool statsEnabled() const
+		{
+			return m_statsEnabled;
+		}
+
+		// 現在のフレームでここまでに記録された統計情報
+		[[nodiscard]]
+		const CanvasStats& stats() const
+		{
+			return m_stats;
+		}
+
+		// 直前のフレームの統計情報
+		[[nodiscard]]
+		const CanvasStats& lastFrameStats() const
+		{
+			return m_lastFrameStats;
+		}
+
+		void resetStats()
+		{
+			m_stats = CanvasStats{};
+			m_lastFrameStats = CanvasStats{};
+			m_statsFrameCount = -1;
+		}
+
+		// レイアウト更新要求の記録を有効にする
+		// (どのノードのどの関数からレイアウト更新が要求されたかをフレームごとに記録する。スタックトレースの取得は対応環境のみ)
+		void setLayoutInvalidationTracingEnabled(bool enabled, CapturesStackTraceYN capturesStackTrace = CapturesStackTraceYN::No)
+		{
+			m_layoutInvalidationTracingEnabled = enabled;
+			m_capturesLayoutInvalidationStackTrace = capturesStackTrace;
+		}
+
+		[[nodiscard]]
+		bool layoutInvalidationTracingEnabled() const
+		{
+			return m_layoutInvalidationTracingEnabled;
+		}
+
+		// 現在のフレームでここまでに記録されたレイアウト更新要求
+		[[nodiscard]]
+		const Array<LayoutInvalidationRecord>& layoutInvalidations() const
+		{
+			return m_layoutInvalidations;
+		}
+
+		// 直前のフレームのレイアウト更新要求
+		[[nodiscard]]
+		const Array<LayoutInvalidationRecord>& lastFrameLayoutInvalidations() const
+		{
+			return m_lastFrameLayoutInvalidations;
+		}
+
+		// 直前のフレームのレイアウト更新要求の回数と、要求の多いノード・関数の一覧
+		[[nodiscard]]
+		LayoutInvalidationSummary lastFrameLayoutInvalidationSummary(size_t maxOffenderCount = 5) const
+		{
+			return LayoutInvalidationSummary::FromRecords(m_lastFrameLayoutInvalidations, maxOffenderCount);
+		}
+
+		void clearLayoutInvalidations()
+		{
+			m_layoutInvalidations.clear();
+			m_lastFrameLayoutInvalidations.clear();
+			m_layoutInvalidationFrameCount = -1;
+		}
+
+		// レイアウト計算用バッファの容量拡張が発生した回数
+		[[nodiscard]]
+		size_t layoutAllocationCount() const
+		{
+			return m_layoutScratch.allocationCount;
+		}
+
+		// 子ノード数がこの値以上のノードでは、子のサブツリーのレイアウトを並列に計算する(0の場合は並列化しない。既定は0)
+		// (サブツリーごとの計算内容は逐次の場合と同一のため、結果の矩形も逐次の場合と一致する)
+		// (並列化は標準の並列アルゴリズム(std::execution::par)に任せ、入れ子になったサブツリー内ではさらに並列化しない)
+		// (ツリーの形によっては逐次より遅くなるため、NocoBenchのlayout_parallelで効果を確認してから有効にすること)
+		void setParallelLayoutThreshold(size_t threshold)
+		{
+			m_parallelLayoutThreshold = threshold;
+		}
+
+		[[nodiscard]]
+		size_t parallelLayoutThreshold() const
+		{
+			return m_parallelLayoutThreshold;
+		}
+
 		void setOffsetScale(const Vec2& offset, const Vec2& scale)
 		{
 			m_offset = offset;
 			m_scale = scale;
-			m_rootNode->refreshEffectedRect(rootEffectMat(), m_scale);
+			requestRefresh();
 		}
 	};
 }
@@ -0,0 +1,105 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+namespace noco
+{
+	// Canvasの1フレーム分の処理に関する統計情報
+	// (Canvas::setStatsEnabled(true)の場合のみ記録される)
+	struct CanvasStats
+	{
+		size_t updatedNodeCount = 0;
+		size_t drawnNodeCount = 0;
+		size_t componentUpdateCount = 0;
+		size_t componentDrawCount = 0;
+		size_t layoutPassCount = 0;
+		size_t laidOutNodeCount = 0;
+		size_t layoutRequestCount = 0; // refreshContainedCanvasLayoutによるレイアウト更新要求の回数
+		size_t labelCacheRebuildCount = 0;
+		size_t textBoxCacheRebuildCount = 0;
+		size_t scissorChangeCount = 0;
+		size_t dispatchedEventCount = 0; // ノードの状態の変化により通知されたイベントの数
+		size_t skippedUpdateCount = 0; // リテインドモードで省略された更新の回数
+		size_t cachedDrawCount = 0; // リテインドモードで前回の描画結果をそのまま使用した回数
+		size_t partialRedrawRectCount = 0; // 部分再描画で描画し直した矩形の数
+
+		// 各フェーズの経過時間(フェーズ内で発生した他フェーズの時間も含む)
+		Duration updateTime = Duration::zero();
+		Duration layoutTime = Duration::zero();
+		Duration drawTime = Duration::zero();
+
+		void merge(const CanvasStats& other)
+		{
+			updatedNodeCount += other.updatedNodeCount;
+			drawnNodeCount += other.drawnNodeCount;
+			componentUpdateCount += other.componentUpdateCount;
+			componentDrawCount += other.componentDrawCount;
+			layoutPassCount += other.layoutPassCount;
+			laidOutNodeCount += other.laidOutNodeCount;
+			layoutRequestCount += other.layoutRequestCount;
+			labelCacheRebuildCount += other.labelCacheRebuildCount;
+			textBoxCacheRebuildCount += other.textBoxCacheRebuildCount;
+			scissorChangeCount += other.scissorChangeCount;
+			dispatchedEventCount += other.dispatchedEventCount;
+			skippedUpdateCount += other.skippedUpdateCount;
+			cachedDrawCount += other.cachedDrawCount;
+			partialRedrawRectCount += other.partialRedrawRectCount;
+			updateTime += other.updateTime;
+			layoutTime += other.layoutTime;
+			drawTime += other.drawTime;
+		}
+	};
+
+	namespace detail
+	{
+		[[nodiscard]]
+		inline CanvasStats*& CurrentCanvasStatsRef()
+		{
+			thread_local CanvasStats* pStats = nullptr;
+			return pStats;
+		}
+
+		// 現在処理中のCanvasの統計情報(記録しない場合はnullptr)
+		[[nodiscard]]
+		inline CanvasStats* CurrentCanvasStats()
+		{
+			return CurrentCanvasStatsRef();
+		}
+
+		// スコープ内で記録先の統計情報を切り替え、経過時間を加算する
+		// (記録しない場合はnullptrを指定する。入れ子になった別のCanvasの処理が外側に記録されないよう、その場合も切り替えは行う)
+		class ScopedCanvasStats
+		{
+		private:
+			CanvasStats* m_pPrevStats;
+			CanvasStats* m_pStats;
+			Duration CanvasStats::* m_pTime;
+			Optional<Stopwatch> m_stopwatch;
+
+		public:
+			explicit ScopedCanvasStats(CanvasStats* pStats, Duration CanvasStats::* pTime = nullptr)
+				: m_pPrevStats{ CurrentCanvasStatsRef() }
+				, m_pStats{ pStats }
+				, m_pTime{ pTime }
+			{
+				CurrentCanvasStatsRef() = pStats;
+				if (m_pStats && m_pTime)
+				{
+					m_stopwatch.emplace(StartImmediately::Yes);
+				}
+			}
+
+			ScopedCanvasStats(const ScopedCanvasStats&) = delete;
+
+			ScopedCanvasStats& operator=(const ScopedCanvasStats&) = delete;
+
+			~ScopedCanvasStats()
+			{
+				if (m_stopwatch)
+				{
+					m_pStats->*m_pTime += m_stopwatch->elapsed();
+				}
+				CurrentCanvasStatsRef() = m_pPrevStats;
+			}
+		};
+	}
+}
@@ -8,13 +8,69 @@ namespace noco
 {
 	class Node;
 
+	class ComponentBase;
+
 	struct CanvasUpdateContext;
 
+	namespace detail
+	{
+		struct ComponentTypeInfo
+		{
+			// コンポーネントがこの型(またはその派生型)かどうか
+			// (索引の更新(コンポーネントの追加・削除・並べ替え)でのみ使用し、検索時には呼ばない)
+			bool (*isInstance)(const ComponentBase&);
+		};
+
+		// コンポーネントの型ごとに一意なID
+		// (RTTIを使わず、型ごとに実体化される変数のアドレスで識別する)
+		using ComponentTypeId = const ComponentTypeInfo*;
+
+		template <class TComponent>
+		inline constexpr ComponentTypeInfo ComponentTypeInfoOf
+		{
+			.isInstance = [](const ComponentBase& component) { return dynamic_cast<const TComponent*>(&component) != nullptr; },
+		};
+
+		template <class TComponent>
+		[[nodiscard]]
+		constexpr ComponentTypeId ComponentTypeIdOf()
+		{
+			return &ComponentTypeInfoOf<std::remove_cvref_t<TComponent>>;
+		}
+	}
+
 	class ComponentBase
 	{
+		friend class Node;
+
 	private:
 		String m_type;
 		Array<IProperty*> m_properties;
+		uint64 m_changeCount = 0;
+
+		// テンプレート版のaddComponent/emplaceComponentで追加された際の型ID
+		// (型を指定せずに追加し直された場合も索引に登録できるよう、コンポーネント自身が保持する)
+		/* NonSerialized */ detail::ComponentTypeId m_componentTypeId = nullptr;
+
+		// 変更の通知先(追加先のノードが属しているCanvasの変更回数。Canvasに属していない場合はnullptr)
+		/* NonSerialized */ detail::ChangeCounter* m_pChangeCounter = nullptr;
+
+		void setChangeCounter(detail::ChangeCounter* pChangeCounter)
+		{
+			m_pChangeCounter = pChangeCounter;
+			m_changeCount = 0;
+			for (auto* property : m_properties)
+			{
+				property->setChangeCounter(pChangeCounter);
+			}
+		}
+
+	protected:
+		// プロパティ以外の描画に影響する状態を変更した場合に呼ぶ
+		void notifyChanged()
+		{
+			m_changeCount = detail::NotifyChanged(m_pChangeCounter);
+		}
 
 	public:
 		explicit ComponentBase(StringView type, const Array<IProperty*>& properties)
@@ -44,6 +100,31 @@ namespace noco
 		{
 		}
 
+		// 次のフレームも更新が必要な状態かどうか
+		// (リテインドモードのCanvasは、全ノードでfalseかつ入力や変更がなければ更新・描画を省略する)
+		[[nodiscard]]
+		virtual bool requiresUpdate() const
+		{
+			return m_properties.any([](const IProperty* property) { return property->isSmoothing(); });
+		}
+
+		// 描画する範囲(ビュー変換前の座標系)
+		// (部分再描画の範囲の算出に使用する。範囲を特定できない場合はnoneを返す)
+		[[nodiscard]]
+		virtual Optional<RectF> drawBounds(const Node& node) const;
+
+		// プロパティを含め、最後に描画に影響する状態が変更された時点の変更回数
+		[[nodiscard]]
+		uint64 changeCount() const
+		{
+			uint64 changeCount = m_changeCount;
+			for (const auto property : m_properties)
+			{
+				changeCount = Max(changeCount, property->changeCount());
+			}
+			return changeCount;
+		}
+
 		[[nodiscard]]
 		JSON toJSON() const
 		{
@@ -71,12 +152,28 @@ namespace noco
 
 		void updateProperties(InteractState interactState, SelectedYN selected, double deltaTime)
 		{
+			if (detail::SmoothingBatch* pBatch = detail::CurrentSmoothingBatch())
+			{
+				for (auto* property : m_properties)
+				{
+					property->updateBatched(interactState, selected, deltaTime, *pBatch);
+				}
+				return;
+			}
 			for (auto* property : m_properties)
 			{
 				property->update(interactState, selected, deltaTime);
 			}
 		}
 
+		void resetPropertiesSmoothing()
+		{
+			for (auto* property : m_properties)
+			{
+				property->resetSmoothing();
+			}
+		}
+
 		[[nodiscard]]
 		const String& type() const
 		{
@@ -23,5 +23,19 @@ namespace noco
 				m_function(node);
 			}
 		}
+
+		// 描画内容が毎フレーム変化しうるため常に更新が必要
+		[[nodiscard]]
+		bool requiresUpdate() const override
+		{
+			return true;
+		}
+
+		// 任意の描画を行うため範囲は特定できない
+		[[nodiscard]]
+		Optional<RectF> drawBounds(const Node&) const override
+		{
+			return none;
+		}
 	};
 }
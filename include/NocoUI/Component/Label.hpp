@@ -72,6 +72,9 @@ namespace noco
 
 		/* NonSerialized */ mutable Cache m_cache;
 
+		// 余白を除いた文字列の配置範囲を返し、キャッシュを更新する
+		RectF refreshCacheForTextRect(const Node& node) const;
+
 	public:
 		explicit Label(
 			const PropertyValue<String>& text = U"",
@@ -104,6 +107,9 @@ namespace noco
 
 		void draw(const Node& node) const override;
 
+		[[nodiscard]]
+		Optional<RectF> drawBounds(const Node& node) const override;
+
 		[[nodiscard]]
 		const PropertyValue<String>& text() const
 		{
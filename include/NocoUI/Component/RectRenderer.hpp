@@ -40,6 +40,9 @@ namespace noco
 
 		void draw(const Node& node) const override;
 
+		[[nodiscard]]
+		Optional<RectF> drawBounds(const Node& node) const override;
+
 		[[nodiscard]]
 		const PropertyValue<ColorF>& fillColor() const
 		{
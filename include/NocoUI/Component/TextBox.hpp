@@ -205,5 +205,12 @@ namespace noco
 		{
 			return m_isChanged;
 		}
+
+		[[nodiscard]]
+		bool requiresUpdate() const override
+		{
+			// 編集中はキー入力やカーソルの点滅のため毎フレーム更新が必要
+			return m_isEditing || m_isDragging || ComponentBase::requiresUpdate();
+		}
 	};
 }
@@ -23,5 +23,12 @@ namespace noco
 				m_function(node);
 			}
 		}
+
+		// 任意の処理を毎フレーム行うため常に更新が必要
+		[[nodiscard]]
+		bool requiresUpdate() const override
+		{
+			return true;
+		}
 	};
 }
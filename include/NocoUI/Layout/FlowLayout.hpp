@@ -9,13 +9,17 @@ namespace noco
 {
 	class Node;
 
+	struct LayoutScratch;
+
 	struct FlowLayout
 	{
 		struct MeasureInfo
 		{
 			struct Line
 			{
-				Array<size_t> childIndices;
+				// lineChildIndices内でのこの行の範囲
+				size_t childIndicesBegin = 0;
+				size_t childIndicesEnd = 0;
 				double totalWidth = 0.0;
 				double maxHeight = 0.0;
 				double totalFlexibleWeight = 0.0;
@@ -23,12 +27,22 @@ namespace noco
 			};
 			Array<Line> lines;
 
+			// 全行の子要素インデックスを行順に連結したもの
+			// (行ごとにArrayを持つとその分ヒープ確保が発生するため1つにまとめている)
+			Array<size_t> lineChildIndices;
+
 			struct MeasuredChild
 			{
 				SizeF size;
 				LRTB margin;
 			};
 			Array<MeasuredChild> measuredChildren;
+
+			[[nodiscard]]
+			std::span<const size_t> childIndices(const Line& line) const
+			{
+				return std::span<const size_t>{ lineChildIndices.data() + line.childIndicesBegin, line.childIndicesEnd - line.childIndicesBegin };
+			}
 		};
 
 		LRTB padding = LRTB::Zero();
@@ -41,68 +55,22 @@ namespace noco
 		[[nodiscard]]
 		static FlowLayout FromJSON(const JSON& json);
 
-		MeasureInfo measure(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children) const;
+		void measure(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, MeasureInfo& measureInfo) const;
 
 		template <class Fty>
-		void execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Fty fnSetRect) const
+		void execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch, Fty fnSetRect) const
 			requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>;
 
+		// (スレッドごとに保持する作業領域を使い回す)
 		[[nodiscard]]
 		SizeF fittingSizeToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children) const;
 
-		void setBoxConstraintToFitToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Node& node, FitTarget fitTarget, RefreshesLayoutYN refreshesLayout) const;
-	};
-
-	template <class Fty>
-	void FlowLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Fty fnSetRect) const
-		requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>
-	{
-		const auto measureInfo = measure(parentRect, children);
-		const double availableWidth = parentRect.w - (padding.left + padding.right);
+		[[nodiscard]]
+		SizeF fittingSizeToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch) const;
 
-		// 実際に配置していく
-		double offsetY = padding.top;
-		for (auto& line : measureInfo.lines)
-		{
-			double offsetX = padding.left;
-			if (horizontalAlign == HorizontalAlign::Center)
-			{
-				offsetX += (availableWidth - line.totalWidth) / 2;
-			}
-			else if (horizontalAlign == HorizontalAlign::Right)
-			{
-				offsetX += availableWidth - line.totalWidth;
-			}
-			const double lineHeight = line.maxHeight;
-			for (size_t index : line.childIndices)
-			{
-				const auto& child = children[index];
-				if (const auto pBoxConstraint = child->boxConstraint())
-				{
-					const auto& measuredChild = measureInfo.measuredChildren[index];
-
-					const double w = measuredChild.size.x;
-					const double h = measuredChild.size.y;
-					const double marginLeft = measuredChild.margin.left;
-					const double marginRight = measuredChild.margin.right;
-					const double marginTop = measuredChild.margin.top;
-					const double marginBottom = measuredChild.margin.bottom;
-
-					const double shiftY = lineHeight - (h + marginTop + marginBottom);
-					const Vec2 pos = parentRect.pos + Vec2{ offsetX + marginLeft, offsetY + marginTop + shiftY };
-					const RectF finalRect{ pos, measuredChild.size };
-					fnSetRect(child, finalRect);
-
-					offsetX += (w + marginLeft + marginRight);
-				}
-				else if (const auto pAnchorConstraint = child->anchorConstraint())
-				{
-					const RectF finalRect = pAnchorConstraint->applyConstraint(parentRect, Vec2::Zero());
-					fnSetRect(child, finalRect);
-				}
-			}
+		void setBoxConstraintToFitToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Node& node, FitTarget fitTarget, RefreshesLayoutYN refreshesLayout) const;
 
-			offsetY += lineHeight;
-		}
-	}
+		[[nodiscard]]
+		bool operator==(const FlowLayout& other) const = default;
+	};
 }
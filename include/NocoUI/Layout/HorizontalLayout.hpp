@@ -9,6 +9,8 @@ namespace noco
 {
 	class Node;
 
+	struct LayoutScratch;
+
 	struct HorizontalLayout
 	{
 		LRTB padding = LRTB::Zero();
@@ -22,12 +24,15 @@ namespace noco
 		static HorizontalLayout FromJSON(const JSON& json);
 
 		template <class Fty>
-		void execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Fty fnSetRect) const
+		void execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch, Fty fnSetRect) const
 			requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>;
 
 		[[nodiscard]]
 		SizeF fittingSizeToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children) const;
 
 		void setBoxConstraintToFitToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Node& node, FitTarget fitTarget, RefreshesLayoutYN refreshesLayout) const;
+
+		[[nodiscard]]
+		bool operator==(const HorizontalLayout& other) const = default;
 	};
 }
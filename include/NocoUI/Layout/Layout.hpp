@@ -2,8 +2,52 @@
 #include "FlowLayout.hpp"
 #include "HorizontalLayout.hpp"
 #include "VerticalLayout.hpp"
+#include "../CanvasStats.hpp"
 
 namespace noco
 {
 	using LayoutVariant = std::variant<FlowLayout, HorizontalLayout, VerticalLayout>;
+
+	// レイアウト計算用の作業領域
+	// (レイアウト更新のたびにヒープ確保が発生しないよう、Canvas単位で保持して使い回す)
+	struct LayoutScratch
+	{
+		Array<SizeF> sizes;
+		Array<LRTB> margins;
+		FlowLayout::MeasureInfo flowMeasureInfo;
+		Array<CanvasStats> parallelStats; // 並列レイアウトで子ごとに記録する統計情報
+
+		// バッファの容量拡張が発生した回数
+		// (作業領域以外のヒープ確保は数えないため、ヒープ確保がないことの確認には使えない。診断用)
+		size_t allocationCount = 0;
+
+		// 子要素数に合わせてバッファを空にし、必要な場合のみ容量を拡張する
+		void prepare(size_t childCount)
+		{
+			prepareBuffer(sizes, childCount);
+			prepareBuffer(margins, childCount);
+			prepareBuffer(flowMeasureInfo.lines, childCount + 1); // 行数は最大でも子要素数+1
+			prepareBuffer(flowMeasureInfo.lineChildIndices, childCount);
+			prepareBuffer(flowMeasureInfo.measuredChildren, childCount);
+		}
+
+		// 並列レイアウトの子ごとの統計情報を空の状態で用意する
+		void prepareParallelStats(size_t childCount)
+		{
+			prepareBuffer(parallelStats, childCount);
+			parallelStats.resize(childCount);
+		}
+
+	private:
+		template <class T>
+		void prepareBuffer(Array<T>& buffer, size_t size)
+		{
+			buffer.clear();
+			if (buffer.capacity() < size)
+			{
+				buffer.reserve(size);
+				++allocationCount;
+			}
+		}
+	};
 }
@@ -0,0 +1,39 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <source_location>
+#include "YN.hpp"
+
+namespace noco
+{
+	// レイアウト更新の要求元の記録
+	struct LayoutInvalidationRecord
+	{
+		String nodeName; // Canvas::refreshLayoutを直接呼んだ場合は空
+		String apiName; // 要求元の関数名
+		String sourceLocation; // 要求元のファイル名と行番号
+		String stackTrace; // スタックトレースの取得を有効にした場合のみ
+
+		[[nodiscard]]
+		static LayoutInvalidationRecord Create(StringView nodeName, const std::source_location& location, CapturesStackTraceYN capturesStackTrace);
+	};
+
+	// 1フレーム分のレイアウト更新要求の集計
+	struct LayoutInvalidationSummary
+	{
+		struct Offender
+		{
+			String nodeName;
+			String apiName;
+			size_t count = 0;
+		};
+
+		size_t count = 0;
+		Array<Offender> topOffenders; // 要求回数の多い順
+
+		[[nodiscard]]
+		static LayoutInvalidationSummary FromRecords(const Array<LayoutInvalidationRecord>& records, size_t maxOffenderCount = 5);
+
+		[[nodiscard]]
+		String format() const;
+	};
+}
@@ -83,6 +83,16 @@ namespace noco
 			return m_interactable;
 		}
 
+		// ホバー・押下中の状態を破棄する
+		void reset()
+		{
+			m_mouseOverForHovered = false;
+			m_mouseOverForPressed = false;
+			m_isPressed = false;
+			m_isClicked = false;
+			m_lastUpdateFrame = none;
+		}
+
 		void setInteractable(InteractableYN interactable)
 		{
 			m_interactable = interactable;
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include <source_location>
 #include "YN.hpp"
 #include "PropertyValue.hpp"
 #include "Property.hpp"
@@ -7,11 +8,13 @@
 #include "ScrollableAxisFlags.hpp"
 #include "InteractState.hpp"
 #include "MouseTracker.hpp"
+#include "NodeEvent.hpp"
 #include "TransformEffect.hpp"
 #include "Constraint/Constraint.hpp"
 #include "Layout/Layout.hpp"
 #include "Component/ComponentBase.hpp"
 #include "Enums.hpp"
+#include "detail/ClipStack.hpp"
 
 namespace noco
 {
@@ -36,10 +39,17 @@ namespace noco
 		ActiveYN m_activeSelf = ActiveYN::Yes;
 
 		/* NonSerialized */ std::weak_ptr<Canvas> m_canvas;
+		/* NonSerialized */ detail::ChangeCounter* m_pChangeCounter = nullptr; // m_canvasの変更回数(Canvasに属していない場合はnullptr)
 		/* NonSerialized */ std::weak_ptr<Node> m_parent;
 		/* NonSerialized */ RectF m_layoutAppliedRect{ 0.0, 0.0, 0.0, 0.0 };
-		/* NonSerialized */ RectF m_effectedRect{ 0.0, 0.0, 0.0, 0.0 };
+		/* NonSerialized */ RectF m_effectedRect{ 0.0, 0.0, 0.0, 0.0 }; // 変形後の四角形を囲む軸平行な矩形
+		/* NonSerialized */ Quad m_effectedQuad{ Vec2::Zero(), Vec2::Zero(), Vec2::Zero(), Vec2::Zero() };
+		/* NonSerialized */ bool m_isEffectedAxisAligned = true;
 		/* NonSerialized */ Vec2 m_effectScale{ 1.0, 1.0 };
+		/* NonSerialized */ Mat3x2 m_effectMat = Mat3x2::Identity();
+		/* NonSerialized */ Mat3x2 m_parentEffectMat = Mat3x2::Identity();
+		/* NonSerialized */ Vec2 m_parentEffectScale{ 1.0, 1.0 };
+		/* NonSerialized */ bool m_transformDirty = true;
 		/* NonSerialized */ Vec2 m_scrollOffset{ 0.0, 0.0 };
 		/* NonSerialized */ Smoothing<double> m_scrollBarAlpha{ 0.0 };
 		/* NonSerialized */ MouseTracker m_mouseLTracker;
@@ -50,6 +60,38 @@ namespace noco
 		/* NonSerialized */ InteractState m_currentInteractState = InteractState::Default;
 		/* NonSerialized */ InteractState m_currentInteractStateRight = InteractState::Default;
 
+		// イベントハンドラ
+		// (毎フレーム呼び出すのではなく、状態の変化を検出した場合のみCanvasから呼び出される)
+		/* NonSerialized */ Array<std::pair<NodeEventType, NodeEventHandler>> m_eventHandlers;
+		/* NonSerialized */ bool m_prevHoveredForEvent = false;
+		/* NonSerialized */ bool m_prevPressedForEvent = false;
+
+		// 部分再描画用に、前回再描画範囲の判定を行った時点の描画に影響する状態
+		struct DrawnState
+		{
+			Optional<RectF> bounds; // noneの場合は範囲を特定できない
+			InteractState interactState;
+			bool selected;
+			bool active;
+			uint64 changeCount;
+
+			[[nodiscard]]
+			bool operator==(const DrawnState&) const = default;
+		};
+		/* NonSerialized */ Optional<DrawnState> m_drawnState;
+
+		// レイアウト結果のキャッシュ用
+		// (m_layoutDirtyがtrueのノードは祖先も必ずtrueになっている)
+		/* NonSerialized */ bool m_layoutDirty = true;
+		/* NonSerialized */ RectF m_lastLayoutRect{ 0.0, 0.0, 0.0, 0.0 };
+
+		// コンポーネントの型IDによる索引
+		// (型IDから、m_componentsの並び順で最初にその型として扱える要素の添字を引けるようにする)
+		// (検索で探索した型(基底クラスなど)の結果も登録し、見つからなかった型にはNoComponentIndexを登録する)
+		/* NonSerialized */ HashTable<detail::ComponentTypeId, size_t> m_componentIndexByTypeId;
+
+		static constexpr size_t NoComponentIndex = std::numeric_limits<size_t>::max();
+
 		// イテレーション中の追加・削除で例外を送出するためのガード
 		// (ユーザーコードの呼び出しを含むonActivated/onDeactivated/update/drawのみ対応。シングルスレッドのみ想定)
 		struct IterationGuard
@@ -110,6 +152,32 @@ namespace noco
 
 		void clampScrollOffset();
 
+		void refreshChildrenLayout(LayoutScratch& scratch, size_t parallelLayoutThreshold);
+
+		void refreshEffectedRectIfDirty(const Mat3x2& parentEffectMat, const Vec2& parentEffectScale);
+
+		void draw(detail::ClipStack& clipStack) const;
+
+		void emitEventsIfChanged();
+
+		[[nodiscard]]
+		bool requiresUpdate() const;
+
+		void addDirtyRegionIfChanged(detail::DirtyRegion& dirtyRegion, bool isAnimating);
+
+		void invokeEventHandlers(NodeEventType type);
+
+		void addComponentWithTypeId(std::shared_ptr<ComponentBase>&& component, detail::ComponentTypeId typeId);
+
+		void addComponentIndex(detail::ComponentTypeId typeId);
+
+		void refreshComponentIndex();
+
+		template <class TComponent>
+		[[nodiscard]]
+		std::shared_ptr<TComponent> findComponentByTypeId()
+			requires std::derived_from<TComponent, ComponentBase>;
+
 	public:
 		static std::shared_ptr<Node> Create(StringView name = U"Node", const ConstraintVariant& constraint = BoxConstraint{}, IsHitTargetYN isHitTarget = IsHitTargetYN::Yes, InheritChildrenStateFlags inheritChildrenStateFlags = InheritChildrenStateFlags::None);
 
@@ -164,6 +232,9 @@ namespace noco
 		[[nodiscard]]
 		std::shared_ptr<Node> parent() const;
 
+		[[nodiscard]]
+		std::shared_ptr<Canvas> containedCanvas() const;
+
 		[[nodiscard]]
 		std::shared_ptr<Node> findHoverTargetParent();
 
@@ -173,6 +244,14 @@ namespace noco
 
 		void addComponent(const std::shared_ptr<ComponentBase>& component);
 
+		template <class TComponent>
+		void addComponent(std::shared_ptr<TComponent>&& component)
+			requires std::derived_from<TComponent, ComponentBase>;
+
+		template <class TComponent>
+		void addComponent(const std::shared_ptr<TComponent>& component)
+			requires std::derived_from<TComponent, ComponentBase>;
+
 		void removeComponent(const std::shared_ptr<ComponentBase>& component);
 
 		template <class TComponent, class... Args>
@@ -257,8 +336,25 @@ namespace noco
 
 		void setName(StringView name);
 
+		// 画面上の矩形(Canvasのビュー変換を適用したもの)
+		[[nodiscard]]
+		RectF rect() const;
+
+		// ビュー変換前の座標系での矩形(コンポーネントの描画はこの座標系で行う)
+		[[nodiscard]]
+		const RectF& effectedRect() const;
+
+		// コンポーネントが描画する範囲を含む矩形(ビュー変換前の座標系。範囲を特定できない場合はnone)
+		[[nodiscard]]
+		Optional<RectF> drawBounds() const;
+
+		// ビュー変換前の座標系での四角形
+		[[nodiscard]]
+		const Quad& effectedQuad() const;
+
+		// pointはビュー変換前の座標系(Canvasの更新中はCursor::PosF()がこの座標系になる)
 		[[nodiscard]]
-		const RectF& rect() const;
+		bool hitTest(const Vec2& point) const;
 
 		[[nodiscard]]
 		const Vec2& effectScale() const;
@@ -349,6 +445,10 @@ namespace noco
 
 		void setSelected(bool selected);
 
+		// ホバー・押下の状態と変化中の値を破棄し、子孫も含めて操作されていない状態に戻す
+		// (ツリーから外したノードを使い回す場合に、前回の状態が一瞬表示されないようにするために使用)
+		void resetInteractStateRecursive();
+
 		[[nodiscard]]
 		bool isHovered() const;
 
@@ -420,7 +520,18 @@ namespace noco
 
 		void addOnRightClick(std::function<void(const std::shared_ptr<Node>&)> onRightClick);
 
-		void refreshContainedCanvasLayout();
+		void addEventHandler(NodeEventType type, NodeEventHandler handler);
+
+		void clearEventHandlers();
+
+		[[nodiscard]]
+		bool hasEventHandler(NodeEventType type) const;
+
+		void markLayoutAsDirty();
+
+		// 所属するCanvasのレイアウトを更新する
+		// (呼び出し元の位置はレイアウト更新要求の記録に使用される)
+		void refreshContainedCanvasLayout(const std::source_location& location = std::source_location::current());
 	};
 
 	template<class TComponent, class ...Args>
@@ -432,10 +543,55 @@ namespace noco
 			throw Error{ U"emplaceComponent: Cannot emplace component while iterating" };
 		}
 		auto component = std::make_shared<TComponent>(std::forward<Args>(args)...);
-		addComponent(component);
+		addComponentWithTypeId(std::shared_ptr<ComponentBase>{ component }, detail::ComponentTypeIdOf<TComponent>());
 		return component;
 	}
 
+	template <class TComponent>
+	void Node::addComponent(std::shared_ptr<TComponent>&& component)
+		requires std::derived_from<TComponent, ComponentBase>
+	{
+		addComponentWithTypeId(std::move(component), detail::ComponentTypeIdOf<TComponent>());
+	}
+
+	template <class TComponent>
+	void Node::addComponent(const std::shared_ptr<TComponent>& component)
+		requires std::derived_from<TComponent, ComponentBase>
+	{
+		addComponentWithTypeId(std::shared_ptr<ComponentBase>{ component }, detail::ComponentTypeIdOf<TComponent>());
+	}
+
+	template <class TComponent>
+	[[nodiscard]]
+	std::shared_ptr<TComponent> Node::findComponentByTypeId()
+		requires std::derived_from<TComponent, ComponentBase>
+	{
+		// 索引にある型で検索された場合は索引から直接取得(見つからないことが分かっている型も含む)
+		// (索引は並び順で最初にTComponentとして扱える要素を指すため、前にある派生型の要素も正しく優先される)
+		constexpr detail::ComponentTypeId typeId = detail::ComponentTypeIdOf<TComponent>();
+		if (const auto it = m_componentIndexByTypeId.find(typeId); it != m_componentIndexByTypeId.end())
+		{
+			if (it->second == NoComponentIndex)
+			{
+				return nullptr;
+			}
+			return std::static_pointer_cast<TComponent>(m_components[it->second]);
+		}
+
+		// 索引にない型(基底クラスなど)で初めて検索された場合はdynamic_pointer_castで探索し、結果を索引に登録する
+		// (索引はコンポーネントの追加・削除・並べ替え時に更新されるため、2回目以降は探索しない)
+		for (size_t i = 0; i < m_components.size(); ++i)
+		{
+			if (auto concreteComponent = std::dynamic_pointer_cast<TComponent>(m_components[i]))
+			{
+				m_componentIndexByTypeId.emplace(typeId, i);
+				return concreteComponent;
+			}
+		}
+		m_componentIndexByTypeId.emplace(typeId, NoComponentIndex);
+		return nullptr;
+	}
+
 	template<class ...Args>
 	const std::shared_ptr<Node>& Node::addChildFromJSON(const JSON& json, RefreshesLayoutYN refreshesLayout)
 	{
@@ -448,6 +604,7 @@ namespace noco
 		child->m_parent = shared_from_this();
 		child->refreshActiveInHierarchy();
 		m_children.push_back(std::move(child));
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -481,12 +638,9 @@ namespace noco
 	std::shared_ptr<TComponent> Node::getComponent()
 		requires std::derived_from<TComponent, ComponentBase>
 	{
-		for (const auto& component : m_components)
+		if (auto component = findComponentByTypeId<TComponent>())
 		{
-			if (auto concreteComponent = std::dynamic_pointer_cast<TComponent>(component))
-			{
-				return concreteComponent;
-			}
+			return component;
 		}
 		throw Error{ U"Component not found in node '{}'"_fmt(m_name) };
 	}
@@ -496,14 +650,7 @@ namespace noco
 	std::shared_ptr<TComponent> Node::getComponentOrNull()
 		requires std::derived_from<TComponent, ComponentBase>
 	{
-		for (const auto& component : m_components)
-		{
-			if (auto concreteComponent = std::dynamic_pointer_cast<TComponent>(component))
-			{
-				return concreteComponent;
-			}
-		}
-		return nullptr;
+		return findComponentByTypeId<TComponent>();
 	}
 
 	template <class TComponent>
@@ -545,14 +692,67 @@ namespace noco
 	}
 
 	template <class Fty>
-	void HorizontalLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Fty fnSetRect) const
+	void FlowLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch, Fty fnSetRect) const
+		requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>
+	{
+		scratch.prepare(children.size());
+		auto& measureInfo = scratch.flowMeasureInfo;
+		measure(parentRect, children, measureInfo);
+		const double availableWidth = parentRect.w - (padding.left + padding.right);
+
+		// 実際に配置していく
+		double offsetY = padding.top;
+		for (const auto& line : measureInfo.lines)
+		{
+			double offsetX = padding.left;
+			if (horizontalAlign == HorizontalAlign::Center)
+			{
+				offsetX += (availableWidth - line.totalWidth) / 2;
+			}
+			else if (horizontalAlign == HorizontalAlign::Right)
+			{
+				offsetX += availableWidth - line.totalWidth;
+			}
+			const double lineHeight = line.maxHeight;
+			for (size_t index : measureInfo.childIndices(line))
+			{
+				const auto& child = children[index];
+				if (const auto pBoxConstraint = child->boxConstraint())
+				{
+					const auto& measuredChild = measureInfo.measuredChildren[index];
+
+					const double w = measuredChild.size.x;
+					const double h = measuredChild.size.y;
+					const double marginLeft = measuredChild.margin.left;
+					const double marginRight = measuredChild.margin.right;
+					const double marginTop = measuredChild.margin.top;
+					const double marginBottom = measuredChild.margin.bottom;
+
+					const double shiftY = lineHeight - (h + marginTop + marginBottom);
+					const Vec2 pos = parentRect.pos + Vec2{ offsetX + marginLeft, offsetY + marginTop + shiftY };
+					const RectF finalRect{ pos, measuredChild.size };
+					fnSetRect(child, finalRect);
+
+					offsetX += (w + marginLeft + marginRight);
+				}
+				else if (const auto pAnchorConstraint = child->anchorConstraint())
+				{
+					const RectF finalRect = pAnchorConstraint->applyConstraint(parentRect, Vec2::Zero());
+					fnSetRect(child, finalRect);
+				}
+			}
+
+			offsetY += lineHeight;
+		}
+	}
+
+	template <class Fty>
+	void HorizontalLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch, Fty fnSetRect) const
 		requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>
 	{
-		// TODO: 都度生成しないよう外部に持ちたい
-		Array<SizeF> sizes;
-		sizes.reserve(children.size());
-		Array<LRTB> margins;
-		margins.reserve(children.size());
+		scratch.prepare(children.size());
+		Array<SizeF>& sizes = scratch.sizes;
+		Array<LRTB>& margins = scratch.margins;
 
 		double totalWidth = 0.0;
 		double maxHeight = 0.0;
@@ -679,14 +879,12 @@ namespace noco
 	}
 
 	template <class Fty>
-	void VerticalLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, Fty fnSetRect) const
+	void VerticalLayout::execute(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch, Fty fnSetRect) const
 		requires std::invocable<Fty, const std::shared_ptr<Node>&, const RectF&>
 	{
-		// TODO: 都度生成しないよう外部に持ちたい
-		Array<SizeF> sizes;
-		sizes.reserve(children.size());
-		Array<LRTB> margins;
-		margins.reserve(children.size());
+		scratch.prepare(children.size());
+		Array<SizeF>& sizes = scratch.sizes;
+		Array<LRTB>& margins = scratch.margins;
 
 		double totalHeight = 0.0;
 		double maxWidth = 0.0;
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+namespace noco
+{
+	class Node;
+
+	// ノードの状態の変化によって発生するイベントの種類
+	enum class NodeEventType : uint8
+	{
+		Click,
+		RightClick,
+		HoverEnter,
+		HoverLeave,
+		Press,
+	};
+
+	using NodeEventHandler = std::function<void(const std::shared_ptr<Node>&)>;
+
+	// Canvasの更新中に発生し、ノードの更新がすべて終わった後にまとめて通知されるイベント
+	struct NodeEvent
+	{
+		NodeEventType type;
+		std::shared_ptr<Node> node;
+	};
+}
@@ -5,6 +5,7 @@
 #include "YN.hpp"
 #include "Smoothing.hpp"
 #include "LRTB.hpp"
+#include "detail/ChangeTracking.hpp"
 
 namespace noco
 {
@@ -18,17 +19,81 @@ namespace noco
 		LRTB,
 	};
 
+	class ComponentBase;
+
+	class TransformEffect;
+
 	class IProperty
 	{
+		friend class ComponentBase;
+		friend class TransformEffect;
+
+	private:
+		uint64 m_changeCount = 0;
+
+		// 変更の通知先(属しているCanvasの変更回数。Canvasに属していない場合はnullptr)
+		/* NonSerialized */ detail::ChangeCounter* m_pChangeCounter = nullptr;
+
+		// 通知先が変わると変更回数の基準も変わるため、通知先の設定時に変更回数も初期化する
+		void setChangeCounter(detail::ChangeCounter* pChangeCounter)
+		{
+			m_pChangeCounter = pChangeCounter;
+			m_changeCount = 0;
+		}
+
+	protected:
+		void notifyChanged()
+		{
+			m_changeCount = detail::NotifyChanged(m_pChangeCounter);
+		}
+
 	public:
+		IProperty() = default;
+
+		// 複製したプロパティはCanvasに属していない状態とする(通知先はノードへの追加時に設定される)
+		IProperty(const IProperty&)
+		{
+		}
+
+		// 代入は値の変更として扱い、通知先は代入先のものを維持する
+		IProperty& operator=(const IProperty&)
+		{
+			notifyChanged();
+			return *this;
+		}
+
 		virtual ~IProperty() = default;
 		virtual StringView name() const = 0;
 		virtual void update(InteractState interactState, SelectedYN selected, double deltaTime) = 0;
+
+		// SmoothDampの計算をbatchへ集約する更新(集約しないプロパティは通常のupdateと同じ)
+		virtual void updateBatched(InteractState interactState, SelectedYN selected, double deltaTime, detail::SmoothingBatch&)
+		{
+			update(interactState, selected, deltaTime);
+		}
 		virtual void appendJSON(JSON& json) const = 0;
 		virtual void readFromJSON(const JSON& json) = 0;
 		virtual String propertyValueString() const = 0;
 		virtual bool trySetPropertyValueString(StringView value) = 0;
 		virtual PropertyEditType editType() const = 0;
+
+		// 値が目標値に向けて変化中かどうか
+		virtual bool isSmoothing() const
+		{
+			return false;
+		}
+
+		// 変化中の値を破棄し、既定の状態(Default・非選択)の値で静止させる
+		virtual void resetSmoothing()
+		{
+		}
+
+		// 最後に値が設定された時点の、属しているCanvasでの変更回数(Canvasに属してから変更されていない場合は0)
+		[[nodiscard]]
+		uint64 changeCount() const
+		{
+			return m_changeCount;
+		}
 		virtual Array<String> enumCandidates() const
 		{
 			if (editType() != PropertyEditType::Enum)
@@ -89,6 +154,7 @@ namespace noco
 		void setPropertyValue(const PropertyValue<T>& propertyValue)
 		{
 			m_propertyValue = propertyValue;
+			notifyChanged();
 		}
 
 		[[nodiscard]]
@@ -116,6 +182,7 @@ namespace noco
 				return;
 			}
 			m_propertyValue = PropertyValue<T>::fromJSON(json[m_name]);
+			notifyChanged();
 		}
 
 		[[nodiscard]]
@@ -126,7 +193,12 @@ namespace noco
 
 		bool trySetPropertyValueString(StringView value) override
 		{
-			return m_propertyValue.trySetValueString(value);
+			if (!m_propertyValue.trySetValueString(value))
+			{
+				return false;
+			}
+			notifyChanged();
+			return true;
 		}
 
 		[[nodiscard]]
@@ -227,6 +299,7 @@ namespace noco
 		void setPropertyValue(const PropertyValue<T>& propertyValue)
 		{
 			m_propertyValue = propertyValue;
+			notifyChanged();
 		}
 
 		void update(InteractState interactState, SelectedYN selected, double deltaTime) override
@@ -234,6 +307,22 @@ namespace noco
 			m_smoothing.update(m_propertyValue.value(interactState, selected), m_propertyValue.smoothTime, deltaTime);
 		}
 
+		void updateBatched(InteractState interactState, SelectedYN selected, double deltaTime, detail::SmoothingBatch& batch) override
+		{
+			m_smoothing.updateBatched(m_propertyValue.value(interactState, selected), m_propertyValue.smoothTime, deltaTime, batch);
+		}
+
+		[[nodiscard]]
+		bool isSmoothing() const override
+		{
+			return !m_smoothing.isSettled();
+		}
+
+		void resetSmoothing() override
+		{
+			m_smoothing.reset(m_propertyValue.value(InteractState::Default, SelectedYN::No));
+		}
+
 		[[nodiscard]]
 		void appendJSON(JSON& json) const override
 		{
@@ -247,6 +336,7 @@ namespace noco
 				return;
 			}
 			m_propertyValue = PropertyValue<T>::fromJSON(json[m_name]);
+			notifyChanged();
 			m_smoothing = Smoothing<T>{ m_propertyValue.value(InteractState::Default, SelectedYN::No) };
 		}
 
@@ -258,7 +348,12 @@ namespace noco
 
 		bool trySetPropertyValueString(StringView value) override
 		{
-			return m_propertyValue.trySetValueString(value);
+			if (!m_propertyValue.trySetValueString(value))
+			{
+				return false;
+			}
+			notifyChanged();
+			return true;
 		}
 
 		[[nodiscard]]
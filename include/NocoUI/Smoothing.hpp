@@ -15,6 +15,336 @@ namespace noco
 		{ T::SmoothDamp(t, t, t, 0.0) } -> std::convertible_to<T>;
 	};
 
+	namespace detail
+	{
+		// 現在値が目標値にほぼ到達し、速度もほぼ0になったかどうか
+		template <class T>
+		[[nodiscard]]
+		bool IsSmoothingSettled(const T& current, const T& target, const T& velocity)
+		{
+			constexpr double Epsilon = 1e-6;
+			const auto fnIsSettled = [](double c, double t, double v)
+				{
+					return Abs(c - t) <= Epsilon && Abs(v) <= Epsilon;
+				};
+			if constexpr (std::same_as<T, double>)
+			{
+				return fnIsSettled(current, target, velocity);
+			}
+			else if constexpr (std::same_as<T, Vec2>)
+			{
+				return fnIsSettled(current.x, target.x, velocity.x)
+					&& fnIsSettled(current.y, target.y, velocity.y);
+			}
+			else if constexpr (std::same_as<T, ColorF>)
+			{
+				return fnIsSettled(current.r, target.r, velocity.r)
+					&& fnIsSettled(current.g, target.g, velocity.g)
+					&& fnIsSettled(current.b, target.b, velocity.b)
+					&& fnIsSettled(current.a, target.a, velocity.a);
+			}
+			else if constexpr (requires { current.left; current.right; current.top; current.bottom; })
+			{
+				return fnIsSettled(current.left, target.left, velocity.left)
+					&& fnIsSettled(current.right, target.right, velocity.right)
+					&& fnIsSettled(current.top, target.top, velocity.top)
+					&& fnIsSettled(current.bottom, target.bottom, velocity.bottom);
+			}
+			else
+			{
+				// 判定できない型は常に計算する
+				return false;
+			}
+		}
+
+		// まとめて計算する際にdoubleの列へ展開する成分数(0の場合はまとめて計算できない型)
+		template <class T>
+		[[nodiscard]]
+		constexpr size_t SmoothingLaneCount()
+		{
+			if constexpr (std::same_as<T, double>)
+			{
+				return 1;
+			}
+			else if constexpr (std::same_as<T, Vec2>)
+			{
+				return 2;
+			}
+			else if constexpr (std::same_as<T, ColorF>)
+			{
+				return 4;
+			}
+			else if constexpr (requires(T t) { t.left; t.right; t.top; t.bottom; })
+			{
+				return 4;
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template <class T>
+		void StoreSmoothingLanes(const T& value, double* lanes)
+		{
+			if constexpr (std::same_as<T, double>)
+			{
+				lanes[0] = value;
+			}
+			else if constexpr (std::same_as<T, Vec2>)
+			{
+				lanes[0] = value.x;
+				lanes[1] = value.y;
+			}
+			else if constexpr (std::same_as<T, ColorF>)
+			{
+				lanes[0] = value.r;
+				lanes[1] = value.g;
+				lanes[2] = value.b;
+				lanes[3] = value.a;
+			}
+			else
+			{
+				lanes[0] = value.left;
+				lanes[1] = value.right;
+				lanes[2] = value.top;
+				lanes[3] = value.bottom;
+			}
+		}
+
+		template <class T>
+		void LoadSmoothingLanes(T& value, const double* lanes)
+		{
+			if constexpr (std::same_as<T, double>)
+			{
+				value = lanes[0];
+			}
+			else if constexpr (std::same_as<T, Vec2>)
+			{
+				value.x = lanes[0];
+				value.y = lanes[1];
+			}
+			else if constexpr (std::same_as<T, ColorF>)
+			{
+				value.r = lanes[0];
+				value.g = lanes[1];
+				value.b = lanes[2];
+				value.a = lanes[3];
+			}
+			else
+			{
+				value.left = lanes[0];
+				value.right = lanes[1];
+				value.top = lanes[2];
+				value.bottom = lanes[3];
+			}
+		}
+
+		// 成分ごとのSmoothDamp(Math::SmoothDampと同じ式・同じ演算順序。maxSpeedは指定なし)
+		// (目標値を越えた場合の判定は値の型によって成分ごとか値全体かが異なるため、ここでは行わず書き戻し時に値ごとに行う)
+		// (分岐や関数呼び出しを含まない連続した配列上のループだが、明示的なSIMD命令は使用していない。ベクトル化されるかはコンパイラの最適化次第)
+		inline void SmoothDampLanes(double* currents, double* velocities, const double* targets, const double* smoothTimes, size_t count, double deltaTime)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const double from = currents[i];
+				const double to = targets[i];
+				const double omega = 2.0 / Max(0.0001, smoothTimes[i]);
+				const double x = omega * deltaTime;
+				const double decay = 1.0 / (1.0 + x + 0.48 * x * x + 0.235 * x * x * x);
+				const double change = from - to;
+				const double target = from - change;
+				const double temp = (velocities[i] + omega * change) * deltaTime;
+				velocities[i] = (velocities[i] - omega * temp) * decay;
+				currents[i] = target + (change + temp) * decay;
+			}
+		}
+
+		// SmoothDampLanesの結果が目標値を越えていれば目標値で止める
+		// (Math::SmoothDampと同様に、Vec2・ColorFは成分ごとではなく値全体で判定する。LRTBは成分ごとにSmoothDampするため成分ごとに判定する)
+		template <class T>
+		void ClampSmoothDampOvershoot(const T& from, const T& to, T& result, T& velocity, double deltaTime)
+		{
+			if constexpr (std::same_as<T, double>)
+			{
+				if ((0.0 < (to - from)) == (result > to))
+				{
+					result = to;
+					velocity = ((result - to) / deltaTime);
+				}
+			}
+			else if constexpr (std::same_as<T, Vec2>)
+			{
+				if (0.0 < (to - from).dot(result - to))
+				{
+					result = to;
+					velocity = ((result - to) / deltaTime);
+				}
+			}
+			else if constexpr (std::same_as<T, ColorF>)
+			{
+				if (0.0 < (to.toVec4() - from.toVec4()).dot(result.toVec4() - to.toVec4()))
+				{
+					result = to;
+					velocity = ColorF{ (result.toVec4() - to.toVec4()) / deltaTime };
+				}
+			}
+			else
+			{
+				ClampSmoothDampOvershoot(from.left, to.left, result.left, velocity.left, deltaTime);
+				ClampSmoothDampOvershoot(from.right, to.right, result.right, velocity.right, deltaTime);
+				ClampSmoothDampOvershoot(from.top, to.top, result.top, velocity.top, deltaTime);
+				ClampSmoothDampOvershoot(from.bottom, to.bottom, result.bottom, velocity.bottom, deltaTime);
+			}
+		}
+
+		// Canvas内のSmoothPropertyのSmoothDampをまとめて計算するための作業領域
+		// (ノードの更新中に各プロパティの現在値・速度・目標値を成分ごとの連続した配列に集め、更新後に一括で計算して書き戻す)
+		class SmoothingBatch
+		{
+		private:
+			struct Entry
+			{
+				void* pCurrentValue;
+				void* pVelocity;
+				bool* pIsSettled;
+				size_t laneOffset;
+				void (*fnScatter)(const Entry&, const SmoothingBatch&);
+			};
+
+			Array<double> m_currents;
+			Array<double> m_velocities;
+			Array<double> m_targets;
+			Array<double> m_smoothTimes;
+			Array<Entry> m_entries;
+			double m_deltaTime = 0.0;
+
+			// 書き戻すまでの間にコンポーネントが破棄されないよう所有者を保持する
+			Array<std::shared_ptr<const void>> m_owners;
+
+			template <class T>
+			static void Scatter(const Entry& entry, const SmoothingBatch& batch)
+			{
+				T& currentValue = *static_cast<T*>(entry.pCurrentValue);
+				T& velocity = *static_cast<T*>(entry.pVelocity);
+
+				// 書き戻す前の現在値が計算前の値
+				const T fromValue = currentValue;
+				T targetValue = currentValue;
+				LoadSmoothingLanes(currentValue, &batch.m_currents[entry.laneOffset]);
+				LoadSmoothingLanes(velocity, &batch.m_velocities[entry.laneOffset]);
+				LoadSmoothingLanes(targetValue, &batch.m_targets[entry.laneOffset]);
+				ClampSmoothDampOvershoot(fromValue, targetValue, currentValue, velocity, batch.m_deltaTime);
+
+				*entry.pIsSettled = IsSmoothingSettled(currentValue, targetValue, velocity);
+				if (*entry.pIsSettled)
+				{
+					currentValue = targetValue;
+				}
+			}
+
+		public:
+			template <class T>
+			void push(T& currentValue, T& velocity, bool& isSettled, const T& targetValue, double smoothTime)
+				requires (SmoothingLaneCount<T>() > 0)
+			{
+				constexpr size_t LaneCount = SmoothingLaneCount<T>();
+				const size_t laneOffset = m_currents.size();
+				m_currents.resize(laneOffset + LaneCount);
+				m_velocities.resize(laneOffset + LaneCount);
+				m_targets.resize(laneOffset + LaneCount);
+				m_smoothTimes.resize(laneOffset + LaneCount, smoothTime);
+				StoreSmoothingLanes(currentValue, &m_currents[laneOffset]);
+				StoreSmoothingLanes(velocity, &m_velocities[laneOffset]);
+				StoreSmoothingLanes(targetValue, &m_targets[laneOffset]);
+				m_entries.push_back(Entry{ &currentValue, &velocity, &isSettled, laneOffset, &Scatter<T> });
+			}
+
+			void retain(std::shared_ptr<const void> owner)
+			{
+				m_owners.push_back(std::move(owner));
+			}
+
+			[[nodiscard]]
+			size_t entryCount() const
+			{
+				return m_entries.size();
+			}
+
+			[[nodiscard]]
+			size_t laneCount() const
+			{
+				return m_currents.size();
+			}
+
+			[[nodiscard]]
+			bool isEmpty() const
+			{
+				return m_entries.empty();
+			}
+
+			// まとめて計算して各プロパティへ書き戻し、次のフレームのために空にする(容量は保持する)
+			void execute(double deltaTime)
+			{
+				m_deltaTime = deltaTime;
+				SmoothDampLanes(m_currents.data(), m_velocities.data(), m_targets.data(), m_smoothTimes.data(), m_currents.size(), deltaTime);
+				for (const auto& entry : m_entries)
+				{
+					entry.fnScatter(entry, *this);
+				}
+				clear();
+			}
+
+			void clear()
+			{
+				m_currents.clear();
+				m_velocities.clear();
+				m_targets.clear();
+				m_smoothTimes.clear();
+				m_entries.clear();
+				m_owners.clear();
+			}
+		};
+
+		[[nodiscard]]
+		inline SmoothingBatch*& CurrentSmoothingBatchRef()
+		{
+			thread_local SmoothingBatch* pBatch = nullptr;
+			return pBatch;
+		}
+
+		// 更新中のCanvasのSmoothDampの集約先(まとめて計算しない場合はnullptr)
+		[[nodiscard]]
+		inline SmoothingBatch* CurrentSmoothingBatch()
+		{
+			return CurrentSmoothingBatchRef();
+		}
+
+		// スコープ内でSmoothDampの集約先を切り替える
+		// (まとめて計算しない場合はnullptrを指定する。入れ子になった別のCanvasのプロパティが外側に集約されないよう、その場合も切り替えは行う)
+		class ScopedSmoothingBatch
+		{
+		private:
+			SmoothingBatch* m_pPrevBatch;
+
+		public:
+			explicit ScopedSmoothingBatch(SmoothingBatch* pBatch)
+				: m_pPrevBatch{ CurrentSmoothingBatchRef() }
+			{
+				CurrentSmoothingBatchRef() = pBatch;
+			}
+
+			ScopedSmoothingBatch(const ScopedSmoothingBatch&) = delete;
+
+			ScopedSmoothingBatch& operator=(const ScopedSmoothingBatch&) = delete;
+
+			~ScopedSmoothingBatch()
+			{
+				CurrentSmoothingBatchRef() = m_pPrevBatch;
+			}
+		};
+	}
+
 	template <class T>
 	class Smoothing
 	{
@@ -23,6 +353,7 @@ namespace noco
 	private:
 		/*NonSerialized*/ T m_currentValue;
 		/*NonSerialized*/ T m_velocity;
+		/*NonSerialized*/ bool m_isSettled = false;
 
 	public:
 		explicit Smoothing(const T& initialValue, const T& initialVelocity = T{})
@@ -37,6 +368,12 @@ namespace noco
 			if (smoothTime <= 0.0)
 			{
 				m_currentValue = targetValue;
+				m_isSettled = true;
+				return;
+			}
+			if (m_isSettled && m_currentValue == targetValue)
+			{
+				// 目標値に到達して静止している間は計算不要
 				return;
 			}
 			if constexpr (HasSmoothDamp<T>)
@@ -47,6 +384,38 @@ namespace noco
 			{
 				m_currentValue = T::SmoothDamp(m_currentValue, targetValue, m_velocity, smoothTime, unspecified, deltaTime);
 			}
+
+			// SmoothDampは目標値に漸近するのみで一致しないことがあるため、十分近づいたら目標値に揃えて静止状態とする
+			m_isSettled = detail::IsSmoothingSettled(m_currentValue, targetValue, m_velocity);
+			if (m_isSettled)
+			{
+				m_currentValue = targetValue;
+			}
+		}
+
+		// updateと同じだが、計算を省略できない場合は計算せずにbatchへ集約する(計算結果はbatch.execute()で書き戻される)
+		void updateBatched(const T& targetValue, double smoothTime, double deltaTime, detail::SmoothingBatch& batch)
+		{
+			if constexpr (detail::SmoothingLaneCount<T>() > 0)
+			{
+				if (smoothTime <= 0.0)
+				{
+					m_currentValue = targetValue;
+					m_isSettled = true;
+					return;
+				}
+				if (m_isSettled && m_currentValue == targetValue)
+				{
+					return;
+				}
+				// 書き戻されるまでの間もアニメーション中として扱われるよう、静止状態は書き戻し時に判定し直す
+				m_isSettled = false;
+				batch.push(m_currentValue, m_velocity, m_isSettled, targetValue, smoothTime);
+			}
+			else
+			{
+				update(targetValue, smoothTime, deltaTime);
+			}
 		}
 
 		[[nodiscard]]
@@ -54,5 +423,20 @@ namespace noco
 		{
 			return m_currentValue;
 		}
+
+		// 目標値に到達して静止しているかどうか(一度もupdateしていない場合はfalse)
+		[[nodiscard]]
+		bool isSettled() const
+		{
+			return m_isSettled;
+		}
+
+		// 途中の状態を破棄し、指定した値で静止している状態にする
+		void reset(const T& value)
+		{
+			m_currentValue = value;
+			m_velocity = T{};
+			m_isSettled = true;
+		}
 	};
 }
@@ -0,0 +1,97 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// NOCO_ENABLE_TRACEを定義した場合のみ、UI処理の各フェーズの区間をChrome trace形式(chrome://tracingやPerfettoで表示可能)で記録する
+// (未定義の場合、NOCO_TRACE_ZONE系のマクロは空の文に展開され、計測処理は一切含まれない)
+
+namespace noco::Trace
+{
+#ifdef NOCO_ENABLE_TRACE
+	// 記録を開始する(それまでに記録した内容は破棄される)
+	void Start();
+
+	// 記録を停止する
+	void Stop();
+
+	[[nodiscard]]
+	bool IsRecording();
+
+	// 記録した内容をChrome trace形式のJSONファイルとして書き出す
+	bool Save(FilePathView path);
+#else
+	inline void Start()
+	{
+	}
+
+	inline void Stop()
+	{
+	}
+
+	[[nodiscard]]
+	inline bool IsRecording()
+	{
+		return false;
+	}
+
+	inline bool Save(FilePathView)
+	{
+		return false;
+	}
+#endif
+}
+
+#ifdef NOCO_ENABLE_TRACE
+
+namespace noco::detail
+{
+	// 現在時刻(マイクロ秒。記録開始時刻からの差ではなく、区間の記録時に記録開始時刻との差に変換される)
+	[[nodiscard]]
+	int64 TraceNowMicrosec();
+
+	void AddTraceEvent(StringView name, StringView nodeName, int64 beginMicrosec, int64 endMicrosec);
+
+	// スコープの開始から終了までを1つの区間として記録する
+	// (名前は記録中の場合のみ区間の終了時にコピーされるため、スコープ内で有効な文字列を指定すること)
+	class ScopedTraceZone
+	{
+	private:
+		StringView m_name;
+		StringView m_nodeName;
+		Optional<int64> m_beginMicrosec;
+
+	public:
+		explicit ScopedTraceZone(StringView name, StringView nodeName = U"")
+			: m_name{ name }
+			, m_nodeName{ nodeName }
+		{
+			if (Trace::IsRecording())
+			{
+				m_beginMicrosec = TraceNowMicrosec();
+			}
+		}
+
+		ScopedTraceZone(const ScopedTraceZone&) = delete;
+
+		ScopedTraceZone& operator=(const ScopedTraceZone&) = delete;
+
+		~ScopedTraceZone()
+		{
+			if (m_beginMicrosec)
+			{
+				AddTraceEvent(m_name, m_nodeName, *m_beginMicrosec, TraceNowMicrosec());
+			}
+		}
+	};
+}
+
+#define NOCO_TRACE_CONCAT_IMPL(a, b) a##b
+#define NOCO_TRACE_CONCAT(a, b) NOCO_TRACE_CONCAT_IMPL(a, b)
+#define NOCO_TRACE_ZONE(name) const ::noco::detail::ScopedTraceZone NOCO_TRACE_CONCAT(nocoTraceZone_, __LINE__){ name }
+#define NOCO_TRACE_ZONE_NODE(name, nodeName) const ::noco::detail::ScopedTraceZone NOCO_TRACE_CONCAT(nocoTraceZone_, __LINE__){ name, nodeName }
+
+#else
+
+#define NOCO_TRACE_ZONE(name) ((void)0)
+#define NOCO_TRACE_ZONE_NODE(name, nodeName) ((void)0)
+
+#endif
@@ -22,12 +22,22 @@ namespace noco
 
 	class TransformEffect
 	{
+		friend class Node;
+
 	private:
 		SmoothProperty<Vec2> m_position;
 		SmoothProperty<Vec2> m_scale;
 		SmoothProperty<Vec2> m_pivot;
 		SmoothProperty<double> m_rotation;
 
+		void setChangeCounter(detail::ChangeCounter* pChangeCounter)
+		{
+			m_position.setChangeCounter(pChangeCounter);
+			m_scale.setChangeCounter(pChangeCounter);
+			m_pivot.setChangeCounter(pChangeCounter);
+			m_rotation.setChangeCounter(pChangeCounter);
+		}
+
 	public:
 		TransformEffect(
 			const PropertyValue<Vec2>& position = Vec2::Zero(),
@@ -85,12 +95,46 @@ namespace noco
 			m_rotation.setPropertyValue(rotation);
 		}
 
-		void update(InteractState interactState, SelectedYN selected, double deltaTime)
+		// 値に変化があった場合はtrueを返す
+		bool update(InteractState interactState, SelectedYN selected, double deltaTime)
 		{
+			const Vec2 prevPosition = m_position.value();
+			const Vec2 prevScale = m_scale.value();
+			const Vec2 prevPivot = m_pivot.value();
+			const double prevRotation = m_rotation.value();
 			m_position.update(interactState, selected, deltaTime);
 			m_scale.update(interactState, selected, deltaTime);
 			m_pivot.update(interactState, selected, deltaTime);
 			m_rotation.update(interactState, selected, deltaTime);
+			return m_position.value() != prevPosition
+				|| m_scale.value() != prevScale
+				|| m_pivot.value() != prevPivot
+				|| m_rotation.value() != prevRotation;
+		}
+
+		// いずれかの値が目標値に向けて変化中かどうか
+		[[nodiscard]]
+		bool isSmoothing() const
+		{
+			return m_position.isSmoothing()
+				|| m_scale.isSmoothing()
+				|| m_pivot.isSmoothing()
+				|| m_rotation.isSmoothing();
+		}
+
+		// 最後にいずれかの値が設定された時点の変更回数
+		[[nodiscard]]
+		uint64 changeCount() const
+		{
+			return std::max({ m_position.changeCount(), m_scale.changeCount(), m_pivot.changeCount(), m_rotation.changeCount() });
+		}
+
+		void resetSmoothing()
+		{
+			m_position.resetSmoothing();
+			m_scale.resetSmoothing();
+			m_pivot.resetSmoothing();
+			m_rotation.resetSmoothing();
 		}
 
 		[[nodiscard]]
@@ -17,4 +17,5 @@ namespace noco
 	using FitsWidthYN = YesNo<struct FitsWidthYN_tag>;
 	using FitsHeightYN = YesNo<struct FitsHeightYN_tag>;
 	using FoldedYN = YesNo<struct FoldedYN_tag>;
+	using CapturesStackTraceYN = YesNo<struct CapturesStackTraceYN_tag>;
 }
@@ -0,0 +1,202 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+namespace noco::detail
+{
+	// Canvasごとのノードツリー・プロパティの変更回数
+	// (リテインドモードのCanvasが、前回の更新以降に変更があったかを判定するためのもの)
+	// (Canvasに属しているノード・コンポーネント・プロパティのみが通知する。他のCanvasや、Canvasに属していないノードの変更では増えない)
+	// (レイアウトの並列計算中に通知される場合に備えてatomicとする)
+	class ChangeCounter
+	{
+	private:
+		std::atomic<uint64> m_changeCount{ 0 };
+
+		// ノードの削除・並べ替えなど、変化した範囲をノード単位で特定できない変更の回数
+		std::atomic<uint64> m_structureChangeCount{ 0 };
+
+	public:
+		ChangeCounter() = default;
+
+		ChangeCounter(const ChangeCounter&) = delete;
+
+		ChangeCounter& operator=(const ChangeCounter&) = delete;
+
+		// 変更を通知し、変更後の変更回数を返す
+		uint64 notifyChanged()
+		{
+			return m_changeCount.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		void notifyStructureChanged()
+		{
+			m_structureChangeCount.fetch_add(1, std::memory_order_relaxed);
+			notifyChanged();
+		}
+
+		[[nodiscard]]
+		uint64 changeCount() const
+		{
+			return m_changeCount.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]]
+		uint64 structureChangeCount() const
+		{
+			return m_structureChangeCount.load(std::memory_order_relaxed);
+		}
+	};
+
+	// 通知先(Canvasに属していない場合はnullptr)へ変更を通知し、変更後の変更回数を返す(通知先がない場合は0)
+	inline uint64 NotifyChanged(ChangeCounter* pChangeCounter)
+	{
+		return pChangeCounter ? pChangeCounter->notifyChanged() : 0;
+	}
+
+	inline void NotifyStructureChanged(ChangeCounter* pChangeCounter)
+	{
+		if (pChangeCounter)
+		{
+			pChangeCounter->notifyStructureChanged();
+		}
+	}
+
+	[[nodiscard]]
+	inline RectF BoundingRect(const RectF& rect1, const RectF& rect2)
+	{
+		const double left = Min(rect1.x, rect2.x);
+		const double top = Min(rect1.y, rect2.y);
+		const double right = Max(rect1.x + rect1.w, rect2.x + rect2.w);
+		const double bottom = Max(rect1.y + rect1.h, rect2.y + rect2.h);
+		return RectF{ left, top, right - left, bottom - top };
+	}
+
+	// 再描画が必要な範囲(ビュー変換前の座標系)
+	// (重なる矩形は統合し、矩形の数が多すぎる場合は全体を囲む1つの矩形にまとめる)
+	class DirtyRegion
+	{
+	private:
+		static constexpr size_t MaxRectCount = 8;
+
+		// アンチエイリアスによる境界のにじみを含めるための余白
+		static constexpr double Margin = 2.0;
+
+		Array<RectF> m_rects;
+		bool m_isAll = false;
+
+	public:
+		void add(const RectF& rect)
+		{
+			if (m_isAll || rect.w <= 0.0 || rect.h <= 0.0)
+			{
+				return;
+			}
+
+			// 統合により新たに重なる矩形が生じる場合があるため、重なりがなくなるまで繰り返す
+			RectF merged = rect.stretched(Margin);
+			for (size_t i = 0; i < m_rects.size();)
+			{
+				if (m_rects[i].intersects(merged))
+				{
+					merged = BoundingRect(merged, m_rects[i]);
+					m_rects.erase(m_rects.begin() + i);
+					i = 0;
+				}
+				else
+				{
+					++i;
+				}
+			}
+			m_rects.push_back(merged);
+
+			if (m_rects.size() > MaxRectCount)
+			{
+				RectF bounding = m_rects.front();
+				for (const auto& dirtyRect : m_rects)
+				{
+					bounding = BoundingRect(bounding, dirtyRect);
+				}
+				m_rects = { bounding };
+			}
+		}
+
+		// 範囲を特定できない変化があった場合に全体を再描画対象とする
+		void markAll()
+		{
+			m_isAll = true;
+			m_rects.clear();
+		}
+
+		void clear()
+		{
+			m_rects.clear();
+			m_isAll = false;
+		}
+
+		[[nodiscard]]
+		bool isAll() const
+		{
+			return m_isAll;
+		}
+
+		[[nodiscard]]
+		bool isEmpty() const
+		{
+			return !m_isAll && m_rects.empty();
+		}
+
+		[[nodiscard]]
+		const Array<RectF>& rects() const
+		{
+			return m_rects;
+		}
+	};
+
+	// 更新中のCanvasへ通知する検出結果
+	struct CanvasActivity
+	{
+		// 次のフレームも更新が必要な状態(アニメーション中など)が検出されたかどうか
+		bool requiresUpdate = false;
+
+		// 再描画が必要な範囲の記録先(部分再描画しない場合はnullptr)
+		DirtyRegion* pDirtyRegion = nullptr;
+	};
+
+	[[nodiscard]]
+	inline CanvasActivity*& CurrentCanvasActivityRef()
+	{
+		thread_local CanvasActivity* pActivity = nullptr;
+		return pActivity;
+	}
+
+	// 更新中のリテインドモードのCanvasへの通知先(リテインドモードでない場合はnullptr)
+	[[nodiscard]]
+	inline CanvasActivity* CurrentCanvasActivity()
+	{
+		return CurrentCanvasActivityRef();
+	}
+
+	// スコープ内で次のフレームも更新が必要な状態の検出先を切り替える
+	// (検出しない場合はnullptrを指定する。入れ子になった別のCanvasの検出結果が外側に記録されないよう、その場合も切り替えは行う)
+	class ScopedCanvasActivity
+	{
+	private:
+		CanvasActivity* m_pPrevActivity;
+
+	public:
+		explicit ScopedCanvasActivity(CanvasActivity* pActivity)
+			: m_pPrevActivity{ CurrentCanvasActivityRef() }
+		{
+			CurrentCanvasActivityRef() = pActivity;
+		}
+
+		ScopedCanvasActivity(const ScopedCanvasActivity&) = delete;
+
+		ScopedCanvasActivity& operator=(const ScopedCanvasActivity&) = delete;
+
+		~ScopedCanvasActivity()
+		{
+			CurrentCanvasActivityRef() = m_pPrevActivity;
+		}
+	};
+}
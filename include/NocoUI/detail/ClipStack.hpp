@@ -0,0 +1,167 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+namespace noco::detail
+{
+	// Canvas単位で保持するクリッピング範囲のスタック
+	// (交差済みの矩形を積み、実際の範囲に変化がある場合のみScissorRectを設定する)
+	class ClipStack
+	{
+	private:
+		Array<Rect> m_rects;
+		Rect m_outerScissorRect{ 0, 0, 0, 0 };
+		Optional<ScopedRenderStates2D> m_renderStates;
+		size_t m_scissorChangeCount = 0;
+		Optional<Mat3x2> m_transform = none;
+		bool m_cullsOutside = false;
+
+		// ScissorRectはTransformer2Dの影響を受けないため、ビュー変換がある場合は画面上の矩形に変換する
+		[[nodiscard]]
+		Rect toScreenRect(const Rect& rect) const
+		{
+			if (!m_transform)
+			{
+				return rect;
+			}
+			const Vec2 p0 = m_transform->transformPoint(rect.tl());
+			const Vec2 p1 = m_transform->transformPoint(rect.br());
+			const Vec2 posMin{ Min(p0.x, p1.x), Min(p0.y, p1.y) };
+			const Vec2 posMax{ Max(p0.x, p1.x), Max(p0.y, p1.y) };
+			return RectF{ posMin, posMax - posMin }.asRect();
+		}
+
+		void applyScissorRect(const Rect& rect)
+		{
+			Graphics2D::SetScissorRect(rect);
+			++m_scissorChangeCount;
+		}
+
+	public:
+		ClipStack() = default;
+
+		ClipStack(const ClipStack&) = delete;
+
+		ClipStack& operator=(const ClipStack&) = delete;
+
+		// 現在の座標系から描画先の座標系への変換(変換がない場合はnone)
+		// (Canvasのビュー変換に加え、外側で設定されたTransformer2D・カメラによる変換も含む。setTransformに渡す値として使用する)
+		[[nodiscard]]
+		static Optional<Mat3x2> CurrentGraphicsTransform()
+		{
+			const Mat3x2 transform = Graphics2D::GetLocalTransform() * Graphics2D::GetCameraTransform();
+			if (transform == Mat3x2::Identity())
+			{
+				return none;
+			}
+			return transform;
+		}
+
+		// ビュー変換(noneの場合は変換なし)を設定する
+		// (スタックが空の状態で設定すること。以降pushされる矩形はビュー変換前の座標系のものとして扱う)
+		void setTransform(const Optional<Mat3x2>& transform)
+		{
+			if (!m_rects.empty())
+			{
+				throw Error{ U"ClipStack::setTransform: Stack is not empty" };
+			}
+			m_transform = transform;
+		}
+
+		// クリッピング範囲外のノードの描画を省略するかどうかを設定する
+		// (部分再描画ではノードの描画範囲の外側は再描画の必要がないため省略する。
+		//  通常の描画ではコンポーネントが申告した描画範囲の外側に描画する場合があるため省略しない)
+		void setCullsOutside(bool cullsOutside)
+		{
+			m_cullsOutside = cullsOutside;
+		}
+
+		[[nodiscard]]
+		bool cullsOutside() const
+		{
+			return m_cullsOutside;
+		}
+
+		void push(const Rect& rectBeforeTransform)
+		{
+			const Rect rect = toScreenRect(rectBeforeTransform);
+			if (m_rects.empty())
+			{
+				// ライブラリ外部で設定されたScissorRectとのネストはここでは考慮しないことにする
+				m_outerScissorRect = Graphics2D::GetScissorRect();
+				m_renderStates.emplace(RasterizerState::SolidCullNoneScissor);
+				m_rects.push_back(rect);
+				applyScissorRect(rect);
+				return;
+			}
+
+			const Rect& prevRect = m_rects.back();
+			const Rect overlap = rect.getOverlap(prevRect);
+			const bool changed = overlap != prevRect;
+			m_rects.push_back(overlap);
+			if (changed)
+			{
+				applyScissorRect(overlap);
+			}
+		}
+
+		void pop()
+		{
+			if (m_rects.empty())
+			{
+				throw Error{ U"ClipStack::pop: Stack is empty" };
+			}
+
+			const Rect poppedRect = m_rects.back();
+			m_rects.pop_back();
+			if (m_rects.empty())
+			{
+				Graphics2D::SetScissorRect(m_outerScissorRect);
+				m_renderStates.reset();
+				return;
+			}
+			if (m_rects.back() != poppedRect)
+			{
+				applyScissorRect(m_rects.back());
+			}
+		}
+
+		// 矩形(ビュー変換前の座標系)が現在のクリッピング範囲と重なるかどうか(クリッピングなしの場合は常にtrue)
+		[[nodiscard]]
+		bool intersects(const RectF& rectBeforeTransform) const
+		{
+			if (m_rects.empty())
+			{
+				return true;
+			}
+			return toScreenRect(rectBeforeTransform.stretched(1.0).asRect()).intersects(m_rects.back());
+		}
+
+		[[nodiscard]]
+		bool isEmpty() const
+		{
+			return m_rects.empty();
+		}
+
+		// 現在のクリッピング範囲(クリッピングなしの場合はnone)
+		[[nodiscard]]
+		Optional<Rect> currentRect() const
+		{
+			if (m_rects.empty())
+			{
+				return none;
+			}
+			return m_rects.back();
+		}
+
+		[[nodiscard]]
+		size_t scissorChangeCount() const
+		{
+			return m_scissorChangeCount;
+		}
+
+		void resetScissorChangeCount()
+		{
+			m_scissorChangeCount = 0;
+		}
+	};
+}
@@ -1,35 +1,28 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include "ClipStack.hpp"
 
 namespace noco::detail
 {
 	class ScopedScissorRect
 	{
 	private:
-		static inline size_t s_nestLevel = 0;
-		Rect m_prevScissorRect;
-		ScopedRenderStates2D m_renderStates;
+		ClipStack& m_clipStack;
 
 	public:
-		explicit ScopedScissorRect(const Rect& rect)
-			: m_prevScissorRect(Graphics2D::GetScissorRect())
-			, m_renderStates(RasterizerState::SolidCullNoneScissor)
+		explicit ScopedScissorRect(ClipStack& clipStack, const Rect& rect)
+			: m_clipStack(clipStack)
 		{
-			if (s_nestLevel == 0) // ライブラリ外部で設定されたScissorRectとのネストはここでは考慮しないことにする
-			{
-				Graphics2D::SetScissorRect(rect);
-			}
-			else
-			{
-				Graphics2D::SetScissorRect(rect.getOverlap(m_prevScissorRect));
-			}
-			++s_nestLevel;
+			m_clipStack.push(rect);
 		}
 
 		~ScopedScissorRect()
 		{
-			Graphics2D::SetScissorRect(m_prevScissorRect);
-			--s_nestLevel;
+			m_clipStack.pop();
 		}
+
+		ScopedScissorRect(const ScopedScissorRect&) = delete;
+
+		ScopedScissorRect& operator=(const ScopedScissorRect&) = delete;
 	};
 }
@@ -0,0 +1,10 @@
+﻿#include "NocoUI/Component/ComponentBase.hpp"
+#include "NocoUI/Node.hpp"
+
+namespace noco
+{
+	Optional<RectF> ComponentBase::drawBounds(const Node& node) const
+	{
+		return node.effectedRect();
+	}
+}
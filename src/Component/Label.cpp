@@ -1,5 +1,7 @@
 ﻿#include "NocoUI/Component/Label.hpp"
 #include "NocoUI/Node.hpp"
+#include "NocoUI/CanvasStats.hpp"
+#include "NocoUI/Trace.hpp"
 
 namespace noco
 {
@@ -9,6 +11,12 @@ namespace noco
 		{
 			return;
 		}
+		if (CanvasStats* pStats = detail::CurrentCanvasStats())
+		{
+			++pStats->labelCacheRebuildCount;
+		}
+		NOCO_TRACE_ZONE(U"Label::Cache::refresh");
+
 		prevParams = CacheParams
 		{
 			.text = String{ text },
@@ -88,17 +96,9 @@ namespace noco
 		regionSize = { maxWidth, offset.y - spacing.y };
 	}
 
-	void Label::draw(const Node& node) const
+	RectF Label::refreshCacheForTextRect(const Node& node) const
 	{
-		const auto& text = m_text.value();
-
-		if (text.empty())
-		{
-			return;
-		}
-
 		const Vec2& effectScale = node.effectScale();
-		const Vec2& spacing = m_spacing.value();
 		const LRTB& padding = m_padding.value();
 		const double leftPadding = padding.left * effectScale.x;
 		const double rightPadding = padding.right * effectScale.x;
@@ -106,17 +106,49 @@ namespace noco
 		const double bottomPadding = padding.bottom * effectScale.y;
 
 		// stretchedはtop,right,bottom,leftの順
-		const RectF rect = node.rect().stretched(-topPadding, -rightPadding, -bottomPadding, -leftPadding);
+		const RectF rect = node.effectedRect().stretched(-topPadding, -rightPadding, -bottomPadding, -leftPadding);
 
 		m_cache.refreshIfDirty(
-			text,
+			m_text.value(),
 			m_fontAssetName.value(),
 			m_fontSize.value(),
-			spacing,
+			m_spacing.value(),
 			m_horizontalOverflow.value(),
 			m_verticalOverflow.value(),
 			rect.size / effectScale);
 
+		return rect;
+	}
+
+	Optional<RectF> Label::drawBounds(const Node& node) const
+	{
+		const RectF& effectedRect = node.effectedRect();
+		if (m_text.value().empty() || (m_horizontalOverflow.value() != HorizontalOverflow::Overflow && m_verticalOverflow.value() != VerticalOverflow::Overflow))
+		{
+			return effectedRect;
+		}
+
+		// 矩形からはみ出す場合は、揃え方向によらずはみ出した分だけ両側に広げた範囲とする
+		const RectF rect = refreshCacheForTextRect(node);
+		const Vec2& effectScale = node.effectScale();
+		const double overflowX = Max(m_cache.regionSize.x * effectScale.x - rect.w, 0.0);
+		const double overflowY = Max(m_cache.regionSize.y * effectScale.y - rect.h, 0.0);
+		return effectedRect.stretched(overflowY, overflowX, overflowY, overflowX);
+	}
+
+	void Label::draw(const Node& node) const
+	{
+		const auto& text = m_text.value();
+
+		if (text.empty())
+		{
+			return;
+		}
+
+		const Vec2& effectScale = node.effectScale();
+		const Vec2& spacing = m_spacing.value();
+		const RectF rect = refreshCacheForTextRect(node);
+
 		double posY;
 		const VerticalAlign& verticalAlign = m_verticalAlign.value();
 		switch (verticalAlign)
@@ -1,5 +1,6 @@
 ﻿#include "NocoUI/Component/RectRenderer.hpp"
 #include "NocoUI/Node.hpp"
+#include "NocoUI/detail/ChangeTracking.hpp"
 
 namespace noco
 {
@@ -17,7 +18,7 @@ namespace noco
 
 		if (cornerRadius == 0.0)
 		{
-			const RectF rect = node.rect().stretched(-outlineThickness / 2);
+			const RectF rect = node.effectedRect().stretched(-outlineThickness / 2);
 			if (shadowColor.a > 0.0)
 			{
 				rect.drawShadow(shadowOffset, shadowBlur, shadowSpread, shadowColor);
@@ -33,7 +34,7 @@ namespace noco
 		}
 		else
 		{
-			const RectF rect = node.rect().stretched(-outlineThickness / 2);
+			const RectF rect = node.effectedRect().stretched(-outlineThickness / 2);
 			const RoundRect roundRect = rect.rounded(cornerRadius);
 			if (shadowColor.a > 0.0)
 			{
@@ -49,4 +50,21 @@ namespace noco
 			}
 		}
 	}
+
+	Optional<RectF> RectRenderer::drawBounds(const Node& node) const
+	{
+		const RectF& rect = node.effectedRect();
+		if (m_shadowColor.value().a <= 0.0)
+		{
+			return rect;
+		}
+
+		// 影はぼかしの分も含めて範囲とする
+		const double effectScaleAvg = (node.effectScale().x + node.effectScale().y) / 2;
+		const Vec2 shadowOffset = m_shadowOffset.value() * effectScaleAvg;
+		const double shadowBlur = m_shadowBlur.value() * effectScaleAvg;
+		const double shadowSpread = m_shadowSpread.value() * effectScaleAvg;
+		const RectF shadowRect = rect.movedBy(shadowOffset).stretched(Max(shadowSpread + shadowBlur, 0.0));
+		return detail::BoundingRect(rect, shadowRect);
+	}
 }
@@ -5,7 +5,7 @@ namespace noco
 {
 	void Sprite::draw(const Node& node) const
 	{
-		const RectF& rect = node.rect();
+		const RectF& rect = node.effectedRect();
 		const String& textureAssetName = m_textureAssetName.value();
 		const ColorF& color = m_color.value();
 		if (m_preserveAspect.value())
@@ -10,6 +10,12 @@ namespace noco
 		{
 			return;
 		}
+		if (CanvasStats* pStats = detail::CurrentCanvasStats())
+		{
+			++pStats->textBoxCacheRebuildCount;
+		}
+		NOCO_TRACE_ZONE(U"TextBox::Cache::refresh");
+
 		prevParams = CacheParams
 		{
 			.text = String{ text },
@@ -140,7 +146,7 @@ namespace noco
 		const Vec2& verticalPadding = m_verticalPadding.value() * effectScale.y;
 
 		// stretchedはtop,rigght,bottom,leftの順
-		const RectF rect = node->rect().stretched(-verticalPadding.x, -horizontalPadding.y, -verticalPadding.y, -horizontalPadding.x);
+		const RectF rect = node->effectedRect().stretched(-verticalPadding.x, -horizontalPadding.y, -verticalPadding.y, -horizontalPadding.x);
 
 		if (m_isDragging)
 		{
@@ -485,7 +491,7 @@ namespace noco
 		const Vec2& verticalPadding = m_verticalPadding.value() * effectScale.y;
 
 		// stretchedはtop,rigght,bottom,leftの順
-		const RectF rect = node.rect().stretched(-verticalPadding.x, -horizontalPadding.y, -verticalPadding.y, -horizontalPadding.x);
+		const RectF rect = node.effectedRect().stretched(-verticalPadding.x, -horizontalPadding.y, -verticalPadding.y, -horizontalPadding.x);
 
 		m_cache.refreshIfDirty(
 			m_text,
@@ -497,7 +503,9 @@ namespace noco
 		const Vec2 offset = rect.pos + Vec2{ drawOffsetX * effectScale.x, 0.0 };
 
 		{
-			detail::ScopedScissorRect scissorRect{ rect.asRect() };
+			detail::ClipStack localClipStack;
+			const auto canvas = node.containedCanvas();
+			detail::ScopedScissorRect scissorRect{ canvas ? canvas->clipStack() : localClipStack, rect.asRect() };
 
 			// 選択範囲を描画
 			if (m_selectionAnchor != m_cursorIndex)
@@ -589,5 +597,6 @@ namespace noco
 		{
 			m_prevText = text;
 		}
+		notifyChanged();
 	}
 }
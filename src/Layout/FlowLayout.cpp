@@ -22,10 +22,12 @@ namespace noco
 		};
 	}
 
-	FlowLayout::MeasureInfo FlowLayout::measure(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children) const
+	void FlowLayout::measure(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, MeasureInfo& measureInfo) const
 	{
-		// TODO: 都度生成しないよう外部に持ちたい
-		MeasureInfo measureInfo;
+		// 使い回しのため既存の内容を破棄(容量は保持される)
+		measureInfo.lines.clear();
+		measureInfo.lineChildIndices.clear();
+		measureInfo.measuredChildren.clear();
 		measureInfo.lines.emplace_back(); // 最初の行
 		measureInfo.measuredChildren.reserve(children.size());
 
@@ -69,13 +71,19 @@ namespace noco
 					lastLine.totalFlexibleWeight = currentLineTotalFlexibleWeight;
 
 					// 新しい行へ
-					measureInfo.lines.emplace_back();
+					measureInfo.lines.push_back(
+						MeasureInfo::Line
+						{
+							.childIndicesBegin = measureInfo.lineChildIndices.size(),
+							.childIndicesEnd = measureInfo.lineChildIndices.size(),
+						});
 					currentX = 0.0;
 					currentLineMaxHeight = 0.0;
 					currentLineTotalFlexibleWeight = 0.0;
 				}
 
-				measureInfo.lines.back().childIndices.push_back(i);
+				measureInfo.lineChildIndices.push_back(i);
+				measureInfo.lines.back().childIndicesEnd = measureInfo.lineChildIndices.size();
 				measureInfo.lines.back().boxConstraintChildExists = true;
 				currentX += childW;
 				currentLineTotalFlexibleWeight += Max(pBoxConstraint->flexibleWeight, 0.0);
@@ -89,7 +97,8 @@ namespace noco
 			{
 				// BoxConstraint以外はオフセットに関与しないので、計測結果は空にする
 				measureInfo.measuredChildren.emplace_back();
-				measureInfo.lines.back().childIndices.push_back(i);
+				measureInfo.lineChildIndices.push_back(i);
+				measureInfo.lines.back().childIndicesEnd = measureInfo.lineChildIndices.size();
 			}
 		}
 		if (!measureInfo.lines.empty())
@@ -116,7 +125,7 @@ namespace noco
 				continue;
 			}
 
-			for (const size_t index : line.childIndices)
+			for (const size_t index : measureInfo.childIndices(line))
 			{
 				const auto& child = children[index];
 				if (!child->activeSelf()) // 親の影響を受けないようactiveSelfを使う
@@ -134,20 +143,26 @@ namespace noco
 			}
 			line.totalWidth = availableWidth;
 		}
-
-		return measureInfo;
 	}
 
 	SizeF FlowLayout::fittingSizeToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children) const
 	{
-		const auto measureInfo = measure(parentRect, children);
+		thread_local LayoutScratch scratch;
+		return fittingSizeToChildren(parentRect, children, scratch);
+	}
+
+	SizeF FlowLayout::fittingSizeToChildren(const RectF& parentRect, const Array<std::shared_ptr<Node>>& children, LayoutScratch& scratch) const
+	{
+		scratch.prepare(children.size());
+		measure(parentRect, children, scratch.flowMeasureInfo);
+		const auto& measureInfo = scratch.flowMeasureInfo;
 
 		double maxWidth = 0.0;
 		double totalHeight = padding.top + padding.bottom;
 		for (const auto& line : measureInfo.lines)
 		{
 			double lineWidth = padding.left + padding.right;
-			for (size_t index : line.childIndices)
+			for (size_t index : measureInfo.childIndices(line))
 			{
 				const auto& measuredChild = measureInfo.measuredChildren[index];
 				lineWidth += measuredChild.size.x + measuredChild.margin.left + measuredChild.margin.right;
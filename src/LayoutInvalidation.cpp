@@ -0,0 +1,63 @@
+﻿#include "NocoUI/LayoutInvalidation.hpp"
+#if __has_include(<stacktrace>)
+#include <stacktrace>
+#endif
+
+namespace noco
+{
+	LayoutInvalidationRecord LayoutInvalidationRecord::Create(StringView nodeName, const std::source_location& location, CapturesStackTraceYN capturesStackTrace)
+	{
+		LayoutInvalidationRecord record
+		{
+			.nodeName = String{ nodeName },
+			.apiName = Unicode::Widen(location.function_name()),
+			.sourceLocation = U"{}({})"_fmt(Unicode::Widen(location.file_name()), location.line()),
+			.stackTrace = U"",
+		};
+#if defined(__cpp_lib_stacktrace) && __cpp_lib_stacktrace >= 202011L
+		if (capturesStackTrace)
+		{
+			// 記録処理自体のフレームは除く
+			record.stackTrace = Unicode::FromUTF8(std::to_string(std::stacktrace::current(1)));
+		}
+#else
+		(void)capturesStackTrace; // スタックトレースを取得できない環境では何もしない
+#endif
+		return record;
+	}
+
+	LayoutInvalidationSummary LayoutInvalidationSummary::FromRecords(const Array<LayoutInvalidationRecord>& records, size_t maxOffenderCount)
+	{
+		LayoutInvalidationSummary summary;
+		summary.count = records.size();
+
+		// 同じノード・同じ関数からの要求をまとめて数える(同数の場合は最初に記録された順)
+		HashTable<String, size_t> offenderIndexByKey;
+		for (const auto& record : records)
+		{
+			const String key = U"{}\n{}"_fmt(record.nodeName, record.apiName);
+			const auto [it, inserted] = offenderIndexByKey.try_emplace(key, summary.topOffenders.size());
+			if (inserted)
+			{
+				summary.topOffenders.push_back(Offender{ .nodeName = record.nodeName, .apiName = record.apiName, .count = 0 });
+			}
+			++summary.topOffenders[it->second].count;
+		}
+		summary.topOffenders.stable_sort_by([](const Offender& a, const Offender& b) { return a.count > b.count; });
+		if (summary.topOffenders.size() > maxOffenderCount)
+		{
+			summary.topOffenders.resize(maxOffenderCount);
+		}
+		return summary;
+	}
+
+	String LayoutInvalidationSummary::format() const
+	{
+		String result = U"Layout invalidations: {}"_fmt(count);
+		for (const auto& offender : topOffenders)
+		{
+			result += U"\n  {} x {} ({})"_fmt(offender.count, offender.nodeName.isEmpty() ? StringView{ U"<Canvas>" } : StringView{ offender.nodeName }, offender.apiName);
+		}
+		return result;
+	}
+}
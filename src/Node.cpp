@@ -2,6 +2,7 @@
 #include "NocoUI/Canvas.hpp"
 #include "NocoUI/Component/Component.hpp"
 #include "NocoUI/detail/ScopedScissorRect.hpp"
+#include <execution>
 
 namespace noco
 {
@@ -100,7 +101,29 @@ namespace noco
 
 	void Node::setCanvasRecursive(const std::weak_ptr<Canvas>& canvas)
 	{
+		if (const auto prevCanvas = m_canvas.lock(); prevCanvas && prevCanvas != canvas.lock())
+		{
+			// Canvasから外れる場合(別のCanvasへ移る場合を含む)は、ホバー中であれば元のCanvasでホバー終了を通知して状態を解除する
+			// (取り付け先で再びホバーされた際にHoverEnterが通知されるようにするため)
+			if (m_prevHoveredForEvent && hasEventHandler(NodeEventType::HoverLeave))
+			{
+				prevCanvas->m_pendingEvents.push_back(NodeEvent{ .type = NodeEventType::HoverLeave, .node = shared_from_this() });
+			}
+			m_prevHoveredForEvent = false;
+			m_prevPressedForEvent = false;
+		}
 		m_canvas = canvas;
+
+		// 変更の通知先を属しているCanvasのものに切り替える
+		const auto canvasLocked = canvas.lock();
+		m_pChangeCounter = canvasLocked ? &canvasLocked->m_changeCounter : nullptr;
+		m_transformEffect.setChangeCounter(m_pChangeCounter);
+		for (const auto& component : m_components)
+		{
+			component->setChangeCounter(m_pChangeCounter);
+		}
+
+		m_drawnState.reset();
 		for (const auto& child : m_children)
 		{
 			child->setCanvasRecursive(canvas);
@@ -168,6 +191,7 @@ namespace noco
 	void Node::setConstraint(const ConstraintVariant& constraint, RefreshesLayoutYN refreshesLayout)
 	{
 		m_constraint = constraint;
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -202,6 +226,7 @@ namespace noco
 	void Node::setLayout(const LayoutVariant& layout, RefreshesLayoutYN refreshesLayout)
 	{
 		m_layout = layout;
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -435,6 +460,11 @@ namespace noco
 		return m_parent.lock();
 	}
 
+	std::shared_ptr<Canvas> Node::containedCanvas() const
+	{
+		return m_canvas.lock();
+	}
+
 	std::shared_ptr<Node> Node::findHoverTargetParent()
 	{
 		if (m_isHitTarget)
@@ -458,22 +488,71 @@ namespace noco
 		return false;
 	}
 
-	void Node::addComponent(std::shared_ptr<ComponentBase>&& component)
+	void Node::addComponentWithTypeId(std::shared_ptr<ComponentBase>&& component, detail::ComponentTypeId typeId)
 	{
 		if (m_componentsIterGuard.isIterating())
 		{
 			throw Error{ U"addComponent: Cannot add component while iterating" };
 		}
+		if (typeId != nullptr && component->m_componentTypeId == nullptr)
+		{
+			component->m_componentTypeId = typeId;
+		}
+		component->setChangeCounter(m_pChangeCounter);
 		m_components.push_back(std::move(component));
+
+		// 末尾への追加のため、既に索引にある型の検索結果は見つからなかった型のみ変わりうる
+		for (auto& [indexedTypeId, index] : m_componentIndexByTypeId)
+		{
+			if (index == NoComponentIndex && indexedTypeId->isInstance(*m_components.back()))
+			{
+				index = m_components.size() - 1;
+			}
+		}
+		if (const auto componentTypeId = m_components.back()->m_componentTypeId;
+			componentTypeId != nullptr && !m_componentIndexByTypeId.contains(componentTypeId))
+		{
+			addComponentIndex(componentTypeId);
+		}
+		detail::NotifyStructureChanged(m_pChangeCounter);
 	}
 
-	void Node::addComponent(const std::shared_ptr<ComponentBase>& component)
+	void Node::addComponentIndex(detail::ComponentTypeId typeId)
 	{
-		if (m_componentsIterGuard.isIterating())
+		// 前にある派生型や型IDを持たない要素も含め、並び順で最初にその型として扱えるものを登録する
+		for (size_t i = 0; i < m_components.size(); ++i)
 		{
-			throw Error{ U"addComponent: Cannot add component while iterating" };
+			if (typeId->isInstance(*m_components[i]))
+			{
+				m_componentIndexByTypeId.emplace(typeId, i);
+				return;
+			}
 		}
-		m_components.push_back(component);
+	}
+
+	void Node::refreshComponentIndex()
+	{
+		m_componentIndexByTypeId.clear();
+		for (const auto& component : m_components)
+		{
+			if (const auto typeId = component->m_componentTypeId;
+				typeId != nullptr && !m_componentIndexByTypeId.contains(typeId))
+			{
+				addComponentIndex(typeId);
+			}
+		}
+	}
+
+	void Node::addComponent(std::shared_ptr<ComponentBase>&& component)
+	{
+		// 型を指定せずに追加された場合は、以前に追加された際の型IDがあればそれで索引に登録する
+		addComponentWithTypeId(std::move(component), nullptr);
+	}
+
+	void Node::addComponent(const std::shared_ptr<ComponentBase>& component)
+	{
+		// 型を指定せずに追加された場合は、以前に追加された際の型IDがあればそれで索引に登録する
+		addComponentWithTypeId(std::shared_ptr<ComponentBase>{ component }, nullptr);
 	}
 
 	void Node::removeComponent(const std::shared_ptr<ComponentBase>& component)
@@ -482,7 +561,20 @@ namespace noco
 		{
 			throw Error{ U"removeComponent: Cannot remove component while iterating" };
 		}
-		m_components.remove(component);
+		for (size_t i = 0; i < m_components.size();)
+		{
+			if (m_components[i] == component)
+			{
+				m_components[i]->setChangeCounter(nullptr);
+				m_components.erase(m_components.begin() + i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		refreshComponentIndex();
+		detail::NotifyStructureChanged(m_pChangeCounter);
 	}
 
 	bool Node::moveComponentUp(const std::shared_ptr<ComponentBase>& component)
@@ -503,6 +595,8 @@ namespace noco
 			return false;
 		}
 		std::iter_swap(it, std::prev(it));
+		refreshComponentIndex();
+		detail::NotifyStructureChanged(m_pChangeCounter);
 		return true;
 	}
 
@@ -524,6 +618,8 @@ namespace noco
 			return false;
 		}
 		std::iter_swap(it, std::next(it));
+		refreshComponentIndex();
+		detail::NotifyStructureChanged(m_pChangeCounter);
 		return true;
 	}
 
@@ -541,6 +637,7 @@ namespace noco
 		child->m_parent = shared_from_this();
 		child->refreshActiveInHierarchy();
 		m_children.push_back(std::move(child));
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -562,6 +659,7 @@ namespace noco
 		child->m_parent = shared_from_this();
 		child->refreshActiveInHierarchy();
 		m_children.push_back(child);
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -580,6 +678,7 @@ namespace noco
 		child->m_parent = shared_from_this();
 		child->refreshActiveInHierarchy();
 		m_children.push_back(std::move(child));
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -607,6 +706,7 @@ namespace noco
 		child->refreshActiveInHierarchy();
 		m_children.insert(m_children.begin() + index, child);
 
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -629,6 +729,8 @@ namespace noco
 		child->m_parent.reset();
 		child->refreshActiveInHierarchy();
 		m_children.remove(child);
+		detail::NotifyStructureChanged(m_pChangeCounter); // 削除したノードの範囲はノード単位では検出できないため
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -723,20 +825,71 @@ namespace noco
 
 	void Node::refreshChildrenLayout()
 	{
-		std::visit([this](const auto& layout)
+		if (const auto canvas = m_canvas.lock())
+		{
+			refreshChildrenLayout(canvas->m_layoutScratch, canvas->parallelLayoutThreshold());
+		}
+		else
+		{
+			LayoutScratch scratch;
+			refreshChildrenLayout(scratch, 0);
+		}
+	}
+
+	void Node::refreshChildrenLayout(LayoutScratch& scratch, size_t parallelLayoutThreshold)
+	{
+		// 前回のレイアウト以降に自身以下で変更がなく、自身の矩形も同じであれば子孫の矩形は変わらないため省略
+		if (!m_layoutDirty && m_layoutAppliedRect == m_lastLayoutRect)
+		{
+			return;
+		}
+		m_lastLayoutRect = m_layoutAppliedRect;
+
+		CanvasStats* pStats = detail::CurrentCanvasStats();
+		if (pStats)
+		{
+			++pStats->laidOutNodeCount;
+		}
+		NOCO_TRACE_ZONE_NODE(U"Layout", m_name);
+
+		std::visit([this, &scratch](const auto& layout)
 			{
-				layout.execute(m_layoutAppliedRect, m_children, [this](const std::shared_ptr<Node>& child, const RectF& rect)
+				layout.execute(m_layoutAppliedRect, m_children, scratch, [this](const std::shared_ptr<Node>& child, const RectF& rect)
 					{
 						child->m_layoutAppliedRect = rect;
 						if (child->isParentLayoutAffected())
 						{
 							child->m_layoutAppliedRect.moveBy(-m_scrollOffset);
 						}
+						child->m_transformDirty = true;
 					});
 			}, m_layout);
-		for (const auto& child : m_children)
+		if (parallelLayoutThreshold > 0 && m_children.size() >= parallelLayoutThreshold)
+		{
+			// 子の矩形が確定した時点で各サブツリーは互いに独立しているため並列に計算する
+			// (各サブツリー内ではさらに並列化せず、作業領域はスレッドごとに使い回す)
+			// (統計情報はスレッド間で共有せず、呼び出し元の作業領域に子ごとに記録してから合算する)
+			scratch.prepareParallelStats(pStats ? m_children.size() : 0);
+			Array<CanvasStats>& childStatsList = scratch.parallelStats;
+			std::for_each(std::execution::par, m_children.begin(), m_children.end(),
+				[this, &childStatsList](const std::shared_ptr<Node>& child)
+				{
+					thread_local LayoutScratch threadScratch;
+					CanvasStats* pChildStats = childStatsList.empty() ? nullptr : &childStatsList[&child - m_children.data()];
+					const detail::ScopedCanvasStats scopedStats{ pChildStats };
+					child->refreshChildrenLayout(threadScratch, 0);
+				});
+			for (const auto& childStats : childStatsList)
+			{
+				pStats->merge(childStats);
+			}
+		}
+		else
 		{
-			child->refreshChildrenLayout();
+			for (const auto& child : m_children)
+			{
+				child->refreshChildrenLayout(scratch, parallelLayoutThreshold);
+			}
 		}
 
 		// レイアウト更新後の状態でスクロールオフセットを制限し、変化があれば反映
@@ -750,9 +903,12 @@ namespace noco
 				if (child->isParentLayoutAffected())
 				{
 					child->m_layoutAppliedRect.moveBy(prevScrollOffset - m_scrollOffset);
+					child->m_transformDirty = true;
 				}
 			}
 		}
+
+		m_layoutDirty = false;
 	}
 
 	Optional<RectF> Node::getChildrenContentRect() const
@@ -809,7 +965,7 @@ namespace noco
 		{
 			return nullptr;
 		}
-		const bool mouseOver = m_effectedRect.mouseOver();
+		const bool mouseOver = hitTest(Cursor::PosF());
 		if (m_clippingEnabled && !mouseOver)
 		{
 			return nullptr;
@@ -853,17 +1009,45 @@ namespace noco
 	{
 		const auto thisNode = shared_from_this();
 
-		m_currentInteractState = updateForCurrentInteractState(hoveredNode, parentInteractable);
-		m_currentInteractStateRight = updateForCurrentInteractStateRight(hoveredNode, parentInteractable);
-		if (!m_isHitTarget)
+		if (CanvasStats* pStats = detail::CurrentCanvasStats())
 		{
-			// HitTargetでない場合は親のinteractStateを引き継ぐ
-			m_currentInteractState = ApplyOtherInteractState(m_currentInteractState, parentInteractState);
-			m_currentInteractStateRight = ApplyOtherInteractState(m_currentInteractStateRight, parentInteractStateRight);
+			++pStats->updatedNodeCount;
+			pStats->componentUpdateCount += m_components.size();
+		}
+
+		{
+			NOCO_TRACE_ZONE_NODE(U"InteractState", m_name);
+			m_currentInteractState = updateForCurrentInteractState(hoveredNode, parentInteractable);
+			m_currentInteractStateRight = updateForCurrentInteractStateRight(hoveredNode, parentInteractable);
+			if (!m_isHitTarget)
+			{
+				// HitTargetでない場合は親のinteractStateを引き継ぐ
+				m_currentInteractState = ApplyOtherInteractState(m_currentInteractState, parentInteractState);
+				m_currentInteractStateRight = ApplyOtherInteractState(m_currentInteractStateRight, parentInteractStateRight);
+			}
 		}
-		for (const auto& component : m_components)
 		{
-			component->updateProperties(m_currentInteractState, m_selected, deltaTime);
+			NOCO_TRACE_ZONE_NODE(U"UpdateProperties", m_name);
+			if (detail::SmoothingBatch* pBatch = detail::CurrentSmoothingBatch())
+			{
+				// 集約したプロパティはCanvasの更新の最後に書き戻すため、それまでコンポーネントを保持しておく
+				for (const auto& component : m_components)
+				{
+					const size_t prevEntryCount = pBatch->entryCount();
+					component->updateProperties(m_currentInteractState, m_selected, deltaTime);
+					if (pBatch->entryCount() != prevEntryCount)
+					{
+						pBatch->retain(component);
+					}
+				}
+			}
+			else
+			{
+				for (const auto& component : m_components)
+				{
+					component->updateProperties(m_currentInteractState, m_selected, deltaTime);
+				}
+			}
 		}
 		if (!m_prevActiveInHierarchy.has_value() || m_activeInHierarchy.getBool() != m_prevActiveInHierarchy->getBool()) // YesNoにopetator==がないのでgetBool()を使っている
 		{
@@ -889,10 +1073,14 @@ namespace noco
 			const auto guard = m_componentsIterGuard.scoped();
 			for (const auto& component : m_components)
 			{
+				NOCO_TRACE_ZONE_NODE(component->type(), m_name);
 				component->update(pContext, thisNode);
 			}
-			m_transformEffect.update(m_currentInteractState, m_selected, deltaTime);
-			refreshEffectedRect(parentEffectMat, parentEffectScale);
+			if (m_transformEffect.update(m_currentInteractState, m_selected, deltaTime))
+			{
+				m_transformDirty = true;
+			}
+			refreshEffectedRectIfDirty(parentEffectMat, parentEffectScale);
 		}
 		else
 		{
@@ -903,6 +1091,12 @@ namespace noco
 			}
 		}
 
+		// ハンドラが登録されている場合のみ状態の変化を確認してイベントを発生させる
+		if (!m_eventHandlers.empty())
+		{
+			emitEventsIfChanged();
+		}
+
 		// ホバー中はスクロールバーを表示
 		if (thisNode == scrollableHoveredNode)
 		{
@@ -913,27 +1107,121 @@ namespace noco
 			m_scrollBarAlpha.update(0.0, 0.1, deltaTime);
 		}
 
+		// リテインドモードのCanvasに、次のフレームも更新が必要かどうかと再描画が必要な範囲を通知
+		if (detail::CanvasActivity* pActivity = detail::CurrentCanvasActivity())
+		{
+			if (pActivity->pDirtyRegion)
+			{
+				const bool requiresUpdateNow = requiresUpdate();
+				pActivity->requiresUpdate = pActivity->requiresUpdate || requiresUpdateNow;
+				addDirtyRegionIfChanged(*pActivity->pDirtyRegion, requiresUpdateNow);
+			}
+			else if (!pActivity->requiresUpdate && requiresUpdate())
+			{
+				pActivity->requiresUpdate = true;
+			}
+		}
+
 		{
 			const auto guard = m_childrenIterGuard.scoped();
 			const InteractableYN interactable{ m_interactable && parentInteractable };
 			for (const auto& child : m_children)
 			{
-				child->update(pContext, hoveredNode, scrollableHoveredNode, deltaTime, m_transformEffect.effectMat(parentEffectMat, m_layoutAppliedRect), m_transformEffect.scale().value() * parentEffectScale, interactable, m_currentInteractState, m_currentInteractStateRight);
+				child->update(pContext, hoveredNode, scrollableHoveredNode, deltaTime, m_effectMat, m_effectScale, interactable, m_currentInteractState, m_currentInteractStateRight);
 			}
 		}
 		m_prevActiveInHierarchy = m_activeInHierarchy;
 	}
 
-	void Node::refreshEffectedRect(const Mat3x2& parentEffectMat, const Vec2& parentEffectScale)
+	bool Node::requiresUpdate() const
+	{
+		if (!m_scrollBarAlpha.isSettled() || m_transformEffect.isSmoothing())
+		{
+			return true;
+		}
+		return m_components.any([](const auto& component) { return component->requiresUpdate(); });
+	}
+
+	void Node::addDirtyRegionIfChanged(detail::DirtyRegion& dirtyRegion, bool isAnimating)
+	{
+		uint64 changeCount = 0;
+		for (const auto& component : m_components)
+		{
+			changeCount = Max(changeCount, component->changeCount());
+		}
+		const bool active = m_activeInHierarchy.getBool();
+		const DrawnState drawnState
+		{
+			.bounds = active ? drawBounds() : Optional<RectF>{ RectF{ 0.0, 0.0, 0.0, 0.0 } },
+			.interactState = m_currentInteractState,
+			.selected = m_selected.getBool(),
+			.active = active,
+			.changeCount = changeCount,
+		};
+
+		// アニメーション中は状態が同じでも描画内容が変化している
+		if (!isAnimating && m_drawnState == drawnState)
+		{
+			return;
+		}
+
+		// 変化前後の両方の範囲を再描画する
+		if (!drawnState.bounds || (m_drawnState && !m_drawnState->bounds))
+		{
+			dirtyRegion.markAll();
+		}
+		else
+		{
+			if (m_drawnState)
+			{
+				dirtyRegion.add(*m_drawnState->bounds);
+			}
+			dirtyRegion.add(*drawnState.bounds);
+		}
+		m_drawnState = drawnState;
+	}
+
+	void Node::refreshEffectedRectIfDirty(const Mat3x2& parentEffectMat, const Vec2& parentEffectScale)
 	{
-		const Mat3x2 effectMat = m_transformEffect.effectMat(parentEffectMat, m_layoutAppliedRect);
-		const Vec2 posLeftTop = effectMat.transformPoint(m_layoutAppliedRect.pos);
-		const Vec2 posRightBottom = effectMat.transformPoint(m_layoutAppliedRect.br());
-		m_effectedRect = RectF{ posLeftTop, posRightBottom - posLeftTop };
+		// 自身の変形・矩形と親の変形のいずれにも変化がなければ前回の計算結果を使う
+		if (!m_transformDirty && parentEffectMat == m_parentEffectMat && parentEffectScale == m_parentEffectScale)
+		{
+			return;
+		}
+		m_effectMat = m_transformEffect.effectMat(parentEffectMat, m_layoutAppliedRect);
+		m_isEffectedAxisAligned = m_effectMat._12 == 0.0 && m_effectMat._21 == 0.0;
+		if (m_isEffectedAxisAligned)
+		{
+			// 回転を含まない場合は2点の変換のみで求まる
+			const Vec2 posLeftTop = m_effectMat.transformPoint(m_layoutAppliedRect.pos);
+			const Vec2 posRightBottom = m_effectMat.transformPoint(m_layoutAppliedRect.br());
+			const Vec2 posMin{ Min(posLeftTop.x, posRightBottom.x), Min(posLeftTop.y, posRightBottom.y) };
+			const Vec2 posMax{ Max(posLeftTop.x, posRightBottom.x), Max(posLeftTop.y, posRightBottom.y) };
+			m_effectedRect = RectF{ posMin, posMax - posMin };
+			m_effectedQuad = m_effectedRect.asQuad();
+		}
+		else
+		{
+			m_effectedQuad = Quad{
+				m_effectMat.transformPoint(m_layoutAppliedRect.tl()),
+				m_effectMat.transformPoint(m_layoutAppliedRect.tr()),
+				m_effectMat.transformPoint(m_layoutAppliedRect.br()),
+				m_effectMat.transformPoint(m_layoutAppliedRect.bl()) };
+			m_effectedRect = m_effectedQuad.boundingRect();
+		}
 		m_effectScale = parentEffectScale * m_transformEffect.scale().value();
+		m_parentEffectMat = parentEffectMat;
+		m_parentEffectScale = parentEffectScale;
+		m_transformDirty = false;
+	}
+
+	void Node::refreshEffectedRect(const Mat3x2& parentEffectMat, const Vec2& parentEffectScale)
+	{
+		m_transformDirty = true;
+		refreshEffectedRectIfDirty(parentEffectMat, parentEffectScale);
 		for (const auto& child : m_children)
 		{
-			child->refreshEffectedRect(effectMat, m_effectScale);
+			child->refreshEffectedRect(m_effectMat, m_effectScale);
 		}
 	}
 
@@ -954,6 +1242,8 @@ namespace noco
 		if (scrolledH || scrolledV)
 		{
 			clampScrollOffset();
+			detail::NotifyChanged(m_pChangeCounter);
+			markLayoutAsDirty();
 			if (refreshesLayout)
 			{
 				refreshContainedCanvasLayout();
@@ -962,6 +1252,31 @@ namespace noco
 	}
 
 	void Node::draw() const
+	{
+		if (const auto canvas = m_canvas.lock())
+		{
+			detail::ClipStack& clipStack = canvas->m_clipStack;
+			if (!clipStack.isEmpty())
+			{
+				// Canvasの描画中(コンポーネントの描画内など)に呼び出された場合は、設定済みのビュー変換・クリッピング範囲をそのまま使用する
+				draw(clipStack);
+				return;
+			}
+
+			// 外側で設定されたTransformer2Dは維持したまま、ビュー変換を重ねて適用する
+			const Optional<Transformer2D> transformer = canvas->createViewTransformer();
+			clipStack.setTransform(detail::ClipStack::CurrentGraphicsTransform());
+			draw(clipStack);
+		}
+		else
+		{
+			detail::ClipStack clipStack;
+			clipStack.setTransform(detail::ClipStack::CurrentGraphicsTransform());
+			draw(clipStack);
+		}
+	}
+
+	void Node::draw(detail::ClipStack& clipStack) const
 	{
 		if (!m_activeSelf || !m_activeInHierarchy)
 		{
@@ -972,13 +1287,35 @@ namespace noco
 		Optional<detail::ScopedScissorRect> scissorRect;
 		if (m_clippingEnabled)
 		{
-			scissorRect.emplace(m_effectedRect.asRect());
+			scissorRect.emplace(clipStack, m_effectedRect.asRect());
+			if (clipStack.currentRect()->isEmpty())
+			{
+				// クリッピング範囲が空の場合は子孫も含め何も描画されないため省略
+				return;
+			}
+		}
+
+		// 部分再描画ではクリッピング範囲外の場合は自身の描画を省略
+		// (子はクリッピング範囲内にはみ出している場合があるため省略しない)
+		bool visible = true;
+		if (clipStack.cullsOutside() && clipStack.currentRect())
+		{
+			const Optional<RectF> bounds = drawBounds();
+			visible = !bounds || clipStack.intersects(*bounds);
 		}
 
+		if (visible)
 		{
+			if (CanvasStats* pStats = detail::CurrentCanvasStats())
+			{
+				++pStats->drawnNodeCount;
+				pStats->componentDrawCount += m_components.size();
+			}
+
 			const auto guard = m_componentsIterGuard.scoped();
 			for (const auto& component : m_components)
 			{
+				NOCO_TRACE_ZONE_NODE(component->type(), m_name);
 				component->draw(*this);
 			}
 		}
@@ -986,12 +1323,12 @@ namespace noco
 			const auto guard = m_childrenIterGuard.scoped();
 			for (const auto& child : m_children)
 			{
-				child->draw();
+				child->draw(clipStack);
 			}
 		}
 
 		// スクロールバー描画
-		if (m_scrollBarAlpha.currentValue() > 0.0)
+		if (visible && m_scrollBarAlpha.currentValue() > 0.0)
 		{
 			const bool needHorizontalScrollBar = horizontalScrollable();
 			const bool needVerticalScrollBar = verticalScrollable();
@@ -1082,11 +1419,50 @@ namespace noco
 		m_name = name;
 	}
 
-	const RectF& Node::rect() const
+	RectF Node::rect() const
+	{
+		// ビュー変換はノード側では保持せず、必要になった場合のみ適用する
+		if (const auto canvas = m_canvas.lock())
+		{
+			return canvas->viewTransformedRect(m_effectedRect);
+		}
+		return m_effectedRect;
+	}
+
+	const RectF& Node::effectedRect() const
 	{
 		return m_effectedRect;
 	}
 
+	Optional<RectF> Node::drawBounds() const
+	{
+		RectF bounds = m_effectedRect;
+		for (const auto& component : m_components)
+		{
+			const Optional<RectF> componentBounds = component->drawBounds(*this);
+			if (!componentBounds)
+			{
+				return none;
+			}
+			bounds = detail::BoundingRect(bounds, *componentBounds);
+		}
+		return bounds;
+	}
+
+	const Quad& Node::effectedQuad() const
+	{
+		return m_effectedQuad;
+	}
+
+	bool Node::hitTest(const Vec2& point) const
+	{
+		if (m_isEffectedAxisAligned)
+		{
+			return m_effectedRect.intersects(point);
+		}
+		return m_effectedQuad.intersects(point);
+	}
+
 	const Vec2& Node::effectScale() const
 	{
 		return m_effectScale;
@@ -1119,6 +1495,10 @@ namespace noco
 
 	void Node::setInteractable(InteractableYN interactable)
 	{
+		if (m_interactable.getBool() != interactable.getBool())
+		{
+			detail::NotifyChanged(m_pChangeCounter);
+		}
 		m_interactable = interactable;
 		m_mouseLTracker.setInteractable(interactable);
 		m_mouseRTracker.setInteractable(interactable);
@@ -1138,6 +1518,7 @@ namespace noco
 	{
 		m_activeSelf = activeSelf;
 		refreshActiveInHierarchy();
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1229,6 +1610,7 @@ namespace noco
 		{
 			m_scrollOffset.y = 0.0;
 		}
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1251,6 +1633,7 @@ namespace noco
 			m_scrollableAxisFlags &= ~ScrollableAxisFlags::Horizontal;
 			m_scrollOffset.x = 0.0;
 		}
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1273,6 +1656,7 @@ namespace noco
 			m_scrollableAxisFlags &= ~ScrollableAxisFlags::Vertical;
 			m_scrollOffset.y = 0.0;
 		}
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1286,6 +1670,10 @@ namespace noco
 
 	void Node::setClippingEnabled(ClippingEnabledYN clippingEnabled)
 	{
+		if (m_clippingEnabled.getBool() != clippingEnabled.getBool())
+		{
+			detail::NotifyStructureChanged(m_pChangeCounter);
+		}
 		m_clippingEnabled = clippingEnabled;
 	}
 
@@ -1311,6 +1699,10 @@ namespace noco
 
 	void Node::setSelected(SelectedYN selected)
 	{
+		if (m_selected.getBool() != selected.getBool())
+		{
+			detail::NotifyChanged(m_pChangeCounter);
+		}
 		m_selected = selected;
 	}
 
@@ -1319,6 +1711,28 @@ namespace noco
 		setSelected(SelectedYN{ selected });
 	}
 
+	void Node::resetInteractStateRecursive()
+	{
+		m_mouseLTracker.reset();
+		m_mouseRTracker.reset();
+		m_currentInteractState = InteractState::Default;
+		m_currentInteractStateRight = InteractState::Default;
+		m_prevHoveredForEvent = false;
+		m_prevPressedForEvent = false;
+		m_scrollBarAlpha.reset(0.0);
+		m_transformEffect.resetSmoothing();
+		for (const auto& component : m_components)
+		{
+			component->resetPropertiesSmoothing();
+		}
+		m_transformDirty = true;
+		detail::NotifyChanged(m_pChangeCounter);
+		for (const auto& child : m_children)
+		{
+			child->resetInteractStateRecursive();
+		}
+	}
+
 	bool Node::isHovered() const
 	{
 		return m_mouseLTracker.isHovered();
@@ -1422,6 +1836,8 @@ namespace noco
 			child->refreshActiveInHierarchy();
 		}
 		m_children.clear();
+		detail::NotifyStructureChanged(m_pChangeCounter);
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1441,6 +1857,8 @@ namespace noco
 			throw Error{ U"swapChildren: Child node not found in node '{}'"_fmt(m_name) };
 		}
 		std::iter_swap(it1, it2);
+		detail::NotifyStructureChanged(m_pChangeCounter); // 描画順の変化はノード単位では検出できないため
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1458,6 +1876,8 @@ namespace noco
 			throw Error{ U"swapChildren: Index out of range" };
 		}
 		std::iter_swap(m_children.begin() + index1, m_children.begin() + index2);
+		detail::NotifyStructureChanged(m_pChangeCounter);
+		markLayoutAsDirty();
 		if (refreshesLayout)
 		{
 			refreshContainedCanvasLayout();
@@ -1481,31 +1901,111 @@ namespace noco
 
 	void Node::addOnClick(std::function<void(const std::shared_ptr<Node>&)> onClick)
 	{
-		emplaceComponent<UpdaterComponent>([onClick = std::move(onClick)](const std::shared_ptr<Node>& node)
-			{
-				if (node->isClicked())
-				{
-					onClick(node);
-				}
-			});
+		addEventHandler(NodeEventType::Click, std::move(onClick));
 	}
 
 	void Node::addOnRightClick(std::function<void(const std::shared_ptr<Node>&)> onRightClick)
 	{
-		emplaceComponent<UpdaterComponent>([onRightClick = std::move(onRightClick)](const std::shared_ptr<Node>& node)
+		addEventHandler(NodeEventType::RightClick, std::move(onRightClick));
+	}
+
+	void Node::addEventHandler(NodeEventType type, NodeEventHandler handler)
+	{
+		if (!handler)
+		{
+			throw Error{ U"addEventHandler: Handler is empty" };
+		}
+		m_eventHandlers.emplace_back(type, std::move(handler));
+	}
+
+	void Node::clearEventHandlers()
+	{
+		m_eventHandlers.clear();
+	}
+
+	bool Node::hasEventHandler(NodeEventType type) const
+	{
+		return m_eventHandlers.any([type](const auto& eventHandler) { return eventHandler.first == type; });
+	}
+
+	void Node::emitEventsIfChanged()
+	{
+		const auto canvas = m_canvas.lock();
+		const auto fnEmit =
+			[this, &canvas](NodeEventType type)
 			{
-				if (node->isRightClicked())
+				if (canvas && hasEventHandler(type))
 				{
-					onRightClick(node);
+					canvas->m_pendingEvents.push_back(NodeEvent{ .type = type, .node = shared_from_this() });
 				}
-			});
+			};
+
+		// 非アクティブの場合はホバー・押下状態を解除したものとして扱う
+		const bool active = m_activeInHierarchy.getBool();
+		const bool hovered = active && isHovered();
+		const bool pressed = active && isPressed();
+		if (hovered != m_prevHoveredForEvent)
+		{
+			fnEmit(hovered ? NodeEventType::HoverEnter : NodeEventType::HoverLeave);
+		}
+		if (pressed && !m_prevPressedForEvent)
+		{
+			fnEmit(NodeEventType::Press);
+		}
+		if (active && isClicked())
+		{
+			fnEmit(NodeEventType::Click);
+		}
+		if (active && isRightClicked())
+		{
+			fnEmit(NodeEventType::RightClick);
+		}
+		m_prevHoveredForEvent = hovered;
+		m_prevPressedForEvent = pressed;
 	}
 
-	void Node::refreshContainedCanvasLayout()
+	void Node::invokeEventHandlers(NodeEventType type)
+	{
+		const auto thisNode = shared_from_this();
+
+		// ハンドラ内でハンドラが追加・削除されても安全なよう、添字で走査して呼び出し前にコピーする
+		for (size_t i = 0; i < m_eventHandlers.size(); ++i)
+		{
+			if (m_eventHandlers[i].first != type)
+			{
+				continue;
+			}
+			const NodeEventHandler handler = m_eventHandlers[i].second;
+			handler(thisNode);
+		}
+	}
+
+	void Node::markLayoutAsDirty()
+	{
+		detail::NotifyChanged(m_pChangeCounter);
+
+		// 既にダーティであれば祖先もダーティになっているため打ち切る
+		if (m_layoutDirty)
+		{
+			return;
+		}
+		m_layoutDirty = true;
+		if (const auto parent = m_parent.lock())
+		{
+			parent->markLayoutAsDirty();
+		}
+	}
+
+	void Node::refreshContainedCanvasLayout(const std::source_location& location)
 	{
 		if (const auto canvas = m_canvas.lock())
 		{
-			canvas->refreshLayout();
+			if (CanvasStats* pStats = canvas->statsForCurrentFrame())
+			{
+				++pStats->layoutRequestCount;
+			}
+			canvas->recordLayoutInvalidation(m_name, location);
+			canvas->refreshLayoutImpl();
 		}
 	}
 }
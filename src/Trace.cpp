@@ -0,0 +1,131 @@
+﻿#include "NocoUI/Trace.hpp"
+
+#ifdef NOCO_ENABLE_TRACE
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace noco
+{
+	namespace
+	{
+		struct TraceEvent
+		{
+			String name;
+			String nodeName;
+			int64 beginMicrosec;
+			int64 endMicrosec;
+			int32 threadIndex;
+		};
+
+		// 並列レイアウト中のワーカースレッドからも記録されるため排他制御する
+		struct TraceRecorder
+		{
+			std::mutex mutex;
+			std::atomic<bool> isRecording = false;
+			int64 startMicrosec = 0; // 記録開始時刻(mutexで保護する)
+			Array<TraceEvent> events;
+			HashTable<std::thread::id, int32> threadIndices;
+		};
+
+		TraceRecorder& GetTraceRecorder()
+		{
+			static TraceRecorder recorder;
+			return recorder;
+		}
+	}
+
+	namespace Trace
+	{
+		void Start()
+		{
+			auto& recorder = GetTraceRecorder();
+			const std::lock_guard lock{ recorder.mutex };
+			recorder.events.clear();
+			recorder.threadIndices.clear();
+			recorder.startMicrosec = detail::TraceNowMicrosec();
+			recorder.isRecording = true;
+		}
+
+		void Stop()
+		{
+			GetTraceRecorder().isRecording = false;
+		}
+
+		bool IsRecording()
+		{
+			return GetTraceRecorder().isRecording.load(std::memory_order_relaxed);
+		}
+
+		bool Save(FilePathView path)
+		{
+			auto& recorder = GetTraceRecorder();
+			const std::lock_guard lock{ recorder.mutex };
+
+			Array<JSON> eventsJSON;
+			eventsJSON.reserve(recorder.events.size());
+			for (const auto& event : recorder.events)
+			{
+				JSON eventJSON
+				{
+					{ U"name", event.name },
+					{ U"cat", U"NocoUI" },
+					{ U"ph", U"X" },
+					{ U"ts", event.beginMicrosec },
+					{ U"dur", event.endMicrosec - event.beginMicrosec },
+					{ U"pid", 0 },
+					{ U"tid", event.threadIndex },
+				};
+				if (!event.nodeName.empty())
+				{
+					eventJSON[U"args"][U"node"] = event.nodeName;
+				}
+				eventsJSON.push_back(eventJSON);
+			}
+
+			const JSON json
+			{
+				{ U"traceEvents", eventsJSON },
+				{ U"displayTimeUnit", U"ms" },
+			};
+			return json.save(path);
+		}
+	}
+
+	namespace detail
+	{
+		int64 TraceNowMicrosec()
+		{
+			// 記録開始時刻との差は記録時にmutexの内側で求める
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		void AddTraceEvent(StringView name, StringView nodeName, int64 beginMicrosec, int64 endMicrosec)
+		{
+			auto& recorder = GetTraceRecorder();
+			const std::lock_guard lock{ recorder.mutex };
+			if (!recorder.isRecording)
+			{
+				return;
+			}
+			if (beginMicrosec < recorder.startMicrosec)
+			{
+				// 記録の開始(やり直し)より前に始まった区間は記録しない
+				return;
+			}
+
+			const int32 threadIndex = recorder.threadIndices.try_emplace(std::this_thread::get_id(), static_cast<int32>(recorder.threadIndices.size())).first->second;
+			recorder.events.push_back(TraceEvent
+			{
+				.name = String{ name },
+				.nodeName = String{ nodeName },
+				.beginMicrosec = beginMicrosec - recorder.startMicrosec,
+				.endMicrosec = endMicrosec - recorder.startMicrosec,
+				.threadIndex = threadIndex,
+			});
+		}
+	}
+}
+
+#endif